@@ -0,0 +1,97 @@
+﻿#include "Core/AllocationStats.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+static std::atomic<size_t> s_AllocationCount(0);
+static std::atomic<size_t> s_AllocatedBytes(0);
+static std::atomic<size_t> s_FreeCount(0);
+
+size_t GetAllocationCount()
+{
+    return s_AllocationCount.load(std::memory_order_relaxed);
+}
+
+size_t GetAllocatedBytes()
+{
+    return s_AllocatedBytes.load(std::memory_order_relaxed);
+}
+
+size_t GetFreeCount()
+{
+    return s_FreeCount.load(std::memory_order_relaxed);
+}
+
+static void* CountedAllocate(size_t size)
+{
+    s_AllocationCount.fetch_add(1, std::memory_order_relaxed);
+    s_AllocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    return std::malloc(size ? size : 1);
+}
+
+static void CountedFree(void* ptr)
+{
+    if (!ptr)
+        return;
+    s_FreeCount.fetch_add(1, std::memory_order_relaxed);
+    std::free(ptr);
+}
+
+// 替换全局operator new/delete；带大小的delete也一起替换，转到不带大小的版本，
+// 否则部分工具链上sized delete直接走标准库的实现，释放不计数
+// 超过默认对齐的new（alignas大于16）走标准库自己的实现，不计数
+void* operator new(size_t size)
+{
+    void* ptr = CountedAllocate(size);
+    if (!ptr)
+        throw std::bad_alloc();
+    return ptr;
+}
+
+void* operator new[](size_t size)
+{
+    void* ptr = CountedAllocate(size);
+    if (!ptr)
+        throw std::bad_alloc();
+    return ptr;
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+    return CountedAllocate(size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept
+{
+    return CountedAllocate(size);
+}
+
+void operator delete(void* ptr) noexcept
+{
+    CountedFree(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+    CountedFree(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept
+{
+    operator delete(ptr);
+}
+
+void operator delete[](void* ptr, size_t) noexcept
+{
+    operator delete[](ptr);
+}
+
+void operator delete(void* ptr, const std::nothrow_t&) noexcept
+{
+    CountedFree(ptr);
+}
+
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept
+{
+    CountedFree(ptr);
+}
\ No newline at end of file
@@ -1,26 +1,46 @@
 #include "Core/Application.h"
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
+#include <cstring>
 #include <iostream>
+#include "Graphics/GLExtensions.h"
+#include "Graphics/RenderCommandList.h"
+#include "Core/FramePacer.h"
+#include "Core/RenderThread.h"
+#include "Core/Profiler.h"
 
 // ImGui
 #include "imgui.h"
 #include "backends/imgui_impl_glfw.h"
 #include "backends/imgui_impl_opengl3.h"
 
-// ̬ص
-static void FramebufferSizeCallback(GLFWwindow* window, int width, int height)
+// ӿڸ֡С¼ƳȾ߳ģʽ߳ûGL
+struct ViewportCommand
 {
-    glViewport(0, 0, width, height);
+    int width;
+    int height;
+};
+
+static void SetViewport(const void* data)
+{
+    const ViewportCommand* viewport = static_cast<const ViewportCommand*>(data);
+    glViewport(0, 0, viewport->width, viewport->height);
 }
 
-Application::Application(const std::string& title, int width, int height)
-    : m_Title(title), m_Width(width), m_Height(height), m_Window(nullptr), m_LastFrameTime(0.0f)
+void Application::SetWindowContextCurrent(void* app, bool current)
 {
+    glfwMakeContextCurrent(current ? static_cast<GLFWwindow*>(static_cast<Application*>(app)->m_Window) : nullptr);
 }
 
-Application::~Application()
+void Application::PresentWindow(void* app, int swapInterval)
 {
+    // ڵǰģڳֵ߳ãģʽһ֡ﱻлʱ
+    Application* application = static_cast<Application*>(app);
+    if (swapInterval != application->m_SwapInterval) {
+        glfwSwapInterval(swapInterval);
+        application->m_SwapInterval = swapInterval;
+    }
+    glfwSwapBuffers(static_cast<GLFWwindow*>(application->m_Window));
 }
 
 void Application::Run()
@@ -51,8 +71,14 @@ void Application::Run()
     }
 
     m_Window = window;  // 洰ָ
+    m_SetContextCurrent = &Application::SetWindowContextCurrent;
+    m_Present = &Application::PresentWindow;
     glfwMakeContextCurrent(window);
-    glfwSwapInterval(1); // ֱͬ
+
+    // ֡ĳģʽãĬϴֱͬлʱڳǰãPresentWindow
+    m_FramePacer->SetAdaptiveVSyncSupported(glfwExtensionSupported("WGL_EXT_swap_control_tear") || glfwExtensionSupported("GLX_EXT_swap_control_tear"));
+    m_SwapInterval = m_FramePacer->GetSwapInterval();
+    glfwSwapInterval(m_SwapInterval);
 
     // 4. ʼGLAD
     if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
@@ -61,13 +87,15 @@ void Application::Run()
         glfwTerminate();
         return;
     }
+    SetGLProcLoader(reinterpret_cast<GLProcLoader>(glfwGetProcAddress));
 
-    // 5. ӿںͻص
+    // 5. ӿڣ֮֡С仯ʱѭ¼ӿ
     glViewport(0, 0, m_Width, m_Height);
-    glfwSetFramebufferSizeCallback(window, FramebufferSizeCallback);
+    ViewportCommand viewport = { m_Width, m_Height };
 
-    // 6. ĳʼ
-    Initialize();
+    // 6. ϵͳٵĳʼ
+    GetProfiler().SetThreadName("Main");
+    StartEngine();
 
     // 7. ʼImGui
     if (!InitializeImGui())
@@ -77,37 +105,66 @@ void Application::Run()
     }
 
     // 8. ѭ
-    m_LastFrameTime = (float)glfwGetTime();
+    m_LastFrameTime = glfwGetTime();
     while (!glfwWindowShouldClose(window))
     {
         // deltaTime
-        float currentTime = (float)glfwGetTime();
-        float deltaTime = currentTime - m_LastFrameTime;
+        double currentTime = glfwGetTime();
+        double deltaTime = currentTime - m_LastFrameTime;
         m_LastFrameTime = currentTime;
 
-        // ʼImGui֡
-        BeginImGuiFrame();
+        // ÿһѭһ֡ͼʾһ֡
+        GetProfiler().MarkFrame();
+        PROFILE_ZONE("Frame");
+
+        // лȾ̣߳һ֡֡ʼͳƱ֡Ķѷ
+        BeginEngineFrame();
 
-        // ߼
-        Update(deltaTime);
+        // Сʱ֡Ϊ0ԭӿ
+        ViewportCommand framebuffer;
+        glfwGetFramebufferSize(window, &framebuffer.width, &framebuffer.height);
+        if (framebuffer.width > 0 && framebuffer.height > 0 &&
+            (framebuffer.width != viewport.width || framebuffer.height != viewport.height)) {
+            viewport = framebuffer;
+            GetRenderCommands().Record(&SetViewport, viewport);
+        }
+
+        // ʼImGui֡
+        {
+            PROFILE_ZONE("ImGui::NewFrame");
+            BeginImGuiFrame();
+        }
 
-        // ȾϷ
-        Render();
+        // ģⲽ͸߼ȾϷ
+        UpdateAndRender(deltaTime);
 
         // ȾImGui
-        OnImGuiRender();
+        {
+            PROFILE_ZONE("OnImGuiRender");
+            OnImGuiRender();
+        }
 
         // ImGui֡
-        EndImGuiFrame();
-
-        // ¼
-        glfwSwapBuffers(window);
-        glfwPollEvents();
+        {
+            PROFILE_ZONE("ImGui::Render");
+            EndImGuiFrame();
+        }
+
+        // ߳ģʽ»طű֡
+        EndEngineFrame();
+
+        // ֡ģʽµȵ֡Ľֹʱٽ򽻸Ⱦ̣֮߳֡ͳ
+        PresentFrame(true);
+        {
+            PROFILE_ZONE("PollEvents");
+            glfwPollEvents();
+        }
     }
 
-    // 9. 
-    Shutdown();
+    // 9. ImGuiGL߳ɾջ
+    StopRenderThread();
     ShutdownImGui();
+    StopEngine();
 
     glfwDestroyWindow(window);
     glfwTerminate();
@@ -115,6 +172,69 @@ void Application::Run()
 
 // ============ ImGuiطʵ ============
 
+// ImGuiĻImGuiģһ֡NewFrameʱͻᱻд
+// Ⱦ߳ģʽ¸һݣÿݰһݣбͻȶкƲڴ
+struct Application::ImGuiFrameSnapshot
+{
+    ImDrawData drawData;
+    ImVector<ImDrawList*> drawLists;    // Լеĸ
+};
+
+// ImVectoroperator=ͷٷ䣬ﱣ
+template<typename T>
+static void CopyImVector(ImVector<T>& target, const ImVector<T>& source)
+{
+    target.resize(source.Size);
+    if (source.Size > 0)
+        std::memcpy(target.Data, source.Data, source.size_in_bytes());
+}
+
+// ϴʱûGLȾ̲߳ٶImGuiݣfalseʾ/
+static bool CopyDrawData(const ImDrawData* source, ImDrawData& target, ImVector<ImDrawList*>& drawLists)
+{
+    bool texturesReady = true;
+    if (source->Textures) {
+        for (ImTextureData* texture : *source->Textures) {
+            if (texture->Status != ImTextureStatus_OK)
+                texturesReady = false;
+        }
+    }
+
+    while (drawLists.Size < source->CmdListsCount)
+        drawLists.push_back(IM_NEW(ImDrawList)(ImGui::GetDrawListSharedData()));
+
+    target.Valid = source->Valid;
+    target.CmdListsCount = source->CmdListsCount;
+    target.TotalIdxCount = source->TotalIdxCount;
+    target.TotalVtxCount = source->TotalVtxCount;
+    target.DisplayPos = source->DisplayPos;
+    target.DisplaySize = source->DisplaySize;
+    target.FramebufferScale = source->FramebufferScale;
+    target.OwnerViewport = source->OwnerViewport;
+    target.Textures = texturesReady ? nullptr : source->Textures;
+    target.CmdLists.resize(source->CmdListsCount);
+    for (int i = 0; i < source->CmdListsCount; ++i) {
+        const ImDrawList* from = source->CmdLists[i];
+        ImDrawList* to = drawLists[i];
+        CopyImVector(to->CmdBuffer, from->CmdBuffer);
+        CopyImVector(to->IdxBuffer, from->IdxBuffer);
+        CopyImVector(to->VtxBuffer, from->VtxBuffer);
+        to->Flags = from->Flags;
+        if (texturesReady) {
+            for (ImDrawCmd& command : to->CmdBuffer)
+                command.TexRef = ImTextureRef(command.GetTexID());
+        }
+        target.CmdLists[i] = to;
+    }
+    return texturesReady;
+}
+
+static void RenderImGuiDrawData(const void* data)
+{
+    PROFILE_ZONE("ImGui_ImplOpenGL3_RenderDrawData");
+    ImGui_ImplOpenGL3_RenderDrawData(*static_cast<ImDrawData* const*>(data));
+}
+
 bool Application::InitializeImGui()
 {
     GLFWwindow* window = static_cast<GLFWwindow*>(m_Window);
@@ -134,11 +254,25 @@ bool Application::InitializeImGui()
     if (!ImGui_ImplOpenGL3_Init(glsl_version))
         return false;
 
+    // ˱ڵһNewFrameʱɫͻ壬Ⱦ߳ģʽʱ߳û
+    if (!ImGui_ImplOpenGL3_CreateDeviceObjects())
+        return false;
+
+    for (int i = 0; i < 2; ++i)
+        m_ImGuiSnapshots[i] = new ImGuiFrameSnapshot();
     return true;
 }
 
 void Application::ShutdownImGui()
 {
+    for (int i = 0; i < 2; ++i) {
+        if (!m_ImGuiSnapshots[i])
+            continue;
+        for (ImDrawList* drawList : m_ImGuiSnapshots[i]->drawLists)
+            IM_DELETE(drawList);
+        delete m_ImGuiSnapshots[i];
+        m_ImGuiSnapshots[i] = nullptr;
+    }
     ImGui_ImplOpenGL3_Shutdown();
     ImGui_ImplGlfw_Shutdown();
     ImGui::DestroyContext();
@@ -154,5 +288,20 @@ void Application::BeginImGuiFrame()
 void Application::EndImGuiFrame()
 {
     ImGui::Render();
-    ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+    ImDrawData* drawData = ImGui::GetDrawData();
+    if (!IsRenderThreadEnabled()) {
+        // ߳ģʽڱ֡ʱطţݻЧ
+        GetRenderCommands().Record(&RenderImGuiDrawData, drawData);
+        return;
+    }
+
+    ImGuiFrameSnapshot* snapshot = m_ImGuiSnapshots[GetRenderThread().GetRecordingIndex()];
+    bool texturesReady = CopyDrawData(drawData, snapshot->drawData, snapshot->drawLists);
+    ImDrawData* snapshotData = &snapshot->drawData;
+    GetRenderCommands().Record(&RenderImGuiDrawData, snapshotData);
+
+    // ͼҪʱȾ̻߳дImGuiݣһ֡ύطټ
+    // ֻ仯Ǽ֡
+    if (!texturesReady)
+        m_FlushAfterSubmit = true;
 }
\ No newline at end of file
@@ -0,0 +1,338 @@
+﻿#include "Core/Application.h"
+#include <glad/glad.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <vector>
+#include "Core/CpuFeatures.h"
+#include "Core/JobSystem.h"
+#include "Core/FrameAllocator.h"
+#include "Core/AllocationStats.h"
+#include "Core/FramePacer.h"
+#include "Core/Profiler.h"
+#include "Graphics/ShaderCache.h"
+#include "Graphics/Shader.h"
+#include "Graphics/GLStateCache.h"
+#include "Graphics/RenderQueue.h"
+#include "Graphics/RenderCommandList.h"
+#include "Graphics/HeadlessContext.h"
+#include "Core/RenderThread.h"
+
+// 引擎子系统和每帧的公共流程，窗口模式（Application.cpp）和无头模式共用
+// 这个文件不依赖GLFW和ImGui，无头的性能测试程序只链接这里
+
+Application::Application(const std::string& title, int width, int height)
+    : m_Title(title), m_Width(width), m_Height(height), m_Window(nullptr), m_LastFrameTime(0.0),
+    m_FramePacer(new FramePacer()), m_SwapInterval(1),
+    m_FixedTimestep(1.0 / 60.0), m_MaxStepsPerFrame(5), m_Accumulator(0.0), m_InterpolationAlpha(1.0), m_StepsLastFrame(0),
+    m_SimulationSteps(0), m_VariableSimulationTime(0.0), m_SimulationTime(0.0), m_DroppedSimulationTime(0.0),
+    m_FrameAllocationCount(0), m_FrameAllocatedBytes(0), m_FrameStartAllocationCount(0), m_FrameStartAllocatedBytes(0),
+    m_RenderThreadRequested(false), m_FlushAfterSubmit(false), m_RecordingCommands(nullptr), m_RecordingQueue(nullptr), m_HeadlessContext(nullptr),
+    m_SetContextCurrent(nullptr), m_Present(nullptr)
+{
+    m_ImGuiSnapshots[0] = nullptr;
+    m_ImGuiSnapshots[1] = nullptr;
+}
+
+Application::~Application()
+{
+}
+
+void Application::StartEngine()
+{
+    // 检测CPU特性，确定数学/网格内核使用的指令集
+    const CpuFeatures& cpu = GetCpuFeatures();
+    std::cout << "CPU特性:" << (cpu.sse2 ? " SSE2" : "") << (cpu.sse42 ? " SSE4.2" : "")
+        << (cpu.avx ? " AVX" : "") << (cpu.avx2 ? " AVX2" : "") << (cpu.fma ? " FMA" : "")
+        << (cpu.avx512f ? " AVX-512F" : "") << "，内核使用 " << GetSimdLevelName(GetActiveSimdLevel()) << std::endl;
+    m_JobSystem.reset(new JobSystem());
+    m_FrameAllocator.reset(new FrameAllocator(1024 * 1024));
+    if (Shader::EnableParallelCompile())
+        std::cout << "驱动支持并行着色器编译" << std::endl;
+    m_RenderQueue.reset(new RenderQueue());
+    m_RenderCommands.reset(new RenderCommandList());
+    m_RenderThread.reset(new RenderThread());
+    m_RecordingCommands = m_RenderCommands.get();
+    m_RecordingQueue = m_RenderQueue.get();
+    m_ShaderCache.reset(new ShaderCache("ShaderCache"));
+    if (!m_ShaderCache->Initialize())
+        std::cout << "驱动不支持程序二进制，着色器每次启动都从源码编译" << std::endl;
+    std::cout << "任务系统线程数: " << m_JobSystem->GetThreadCount() << std::endl;
+    Initialize();
+}
+
+void Application::StopEngine()
+{
+    // Shutdown里要删除GL对象，先把上下文收回主线程
+    StopRenderThread();
+    Shutdown();
+    std::cout << "着色器缓存: 命中 " << m_ShaderCache->GetHitCount() << "，未命中 " << m_ShaderCache->GetMissCount()
+        << "，节省约 " << m_ShaderCache->GetSavedMilliseconds() << " ms" << std::endl;
+    m_ShaderCache.reset();
+    m_RenderThread.reset();
+    m_RenderCommands.reset();
+    m_RenderQueue.reset();
+    m_RecordingCommands = nullptr;
+    m_RecordingQueue = nullptr;
+    m_FrameAllocator.reset();
+    m_JobSystem.reset();
+}
+
+bool Application::IsRenderThreadEnabled() const
+{
+    return m_RenderThread && m_RenderThread->IsRunning();
+}
+
+void Application::StopRenderThread()
+{
+    if (!IsRenderThreadEnabled())
+        return;
+    m_RenderThread->Stop();
+    m_SetContextCurrent(this, true);
+}
+
+void Application::BeginEngineFrame()
+{
+    PROFILE_ZONE("BeginEngineFrame");
+    // 渲染线程只在帧之间启动和停止，一帧的命令总是在同一种模式下录制和回放
+    if (m_RenderThreadRequested != IsRenderThreadEnabled())
+    {
+        if (m_RenderThreadRequested)
+        {
+            m_SetContextCurrent(this, false);
+            m_RenderThread->Start(m_SetContextCurrent, m_Present, this);
+        }
+        else
+        {
+            StopRenderThread();
+        }
+    }
+
+    // 先等到两帧前的数据包回放完，再清空帧分配器：那一帧的命令参数在这块内存里
+    if (IsRenderThreadEnabled())
+    {
+        FramePacket& packet = m_RenderThread->BeginFrame();
+        m_RecordingCommands = &packet.commands;
+        m_RecordingQueue = &packet.queue;
+    }
+    else
+    {
+        m_RecordingCommands = m_RenderCommands.get();
+        m_RecordingQueue = m_RenderQueue.get();
+        GetGLStateCache().BeginFrame();
+    }
+    m_FrameAllocator->BeginFrame();
+    m_RecordingCommands->Reset();
+    m_RecordingQueue->Reset();
+    m_FrameStartAllocationCount = GetAllocationCount();
+    m_FrameStartAllocatedBytes = GetAllocatedBytes();
+}
+
+void Application::SetFixedTimestep(double step, int maxStepsPerFrame)
+{
+    // 切换步长时把已走的步数折算进可变部分，总模拟时间连续
+    m_VariableSimulationTime = m_SimulationTime;
+    m_SimulationSteps = 0;
+    m_FixedTimestep = step > 0.0 ? step : 0.0;
+    m_MaxStepsPerFrame = maxStepsPerFrame > 1 ? maxStepsPerFrame : 1;
+    m_Accumulator = 0.0;
+}
+
+static void ExecuteRenderQueue(const void* data)
+{
+    (*static_cast<RenderQueue* const*>(data))->Execute();
+}
+
+void Application::UpdateAndRender(double deltaTime)
+{
+    if (m_FixedTimestep > 0.0)
+    {
+        PROFILE_ZONE("Simulate");
+        m_Accumulator += deltaTime;
+        int steps = 0;
+        while (m_Accumulator >= m_FixedTimestep && steps < m_MaxStepsPerFrame)
+        {
+            Simulate(m_FixedTimestep);
+            m_Accumulator -= m_FixedTimestep;
+            ++m_SimulationSteps;
+            ++steps;
+        }
+
+        // 达到每帧上限仍有整步积压：丢掉整步，只保留不足一步的部分，插值仍然连续
+        if (m_Accumulator >= m_FixedTimestep)
+        {
+            double remainder = std::fmod(m_Accumulator, m_FixedTimestep);
+            m_DroppedSimulationTime += m_Accumulator - remainder;
+            m_Accumulator = remainder;
+        }
+        m_StepsLastFrame = steps;
+        m_InterpolationAlpha = m_Accumulator / m_FixedTimestep;
+        m_SimulationTime = m_VariableSimulationTime + m_SimulationSteps * m_FixedTimestep;
+    }
+    else
+    {
+        PROFILE_ZONE("Simulate");
+        Simulate(deltaTime);
+        m_VariableSimulationTime += deltaTime;
+        m_SimulationTime = m_VariableSimulationTime;
+        m_StepsLastFrame = 1;
+        m_InterpolationAlpha = 1.0;
+    }
+
+    {
+        PROFILE_ZONE("Update");
+        Update(static_cast<float>(deltaTime));
+    }
+
+    // Render里提交绘制包，回放到这里时排序后统一绘制
+    {
+        PROFILE_ZONE("Render");
+        Render();
+    }
+    m_RecordingCommands->Record(&ExecuteRenderQueue, m_RecordingQueue);
+}
+
+void Application::EndEngineFrame()
+{
+    PROFILE_ZONE("EndEngineFrame");
+    if (!IsRenderThreadEnabled())
+        m_RecordingCommands->Execute();
+    m_FrameAllocationCount = GetAllocationCount() - m_FrameStartAllocationCount;
+    m_FrameAllocatedBytes = GetAllocatedBytes() - m_FrameStartAllocatedBytes;
+}
+
+void Application::PresentFrame(bool paced)
+{
+    PROFILE_ZONE("PresentFrame");
+
+    // 帧节奏留在主线程上：限制的是主线程提交帧的间隔，渲染线程模式下呈现晚一帧跟上
+    if (paced)
+    {
+        PROFILE_ZONE("FramePacer::WaitForNextFrame");
+        m_FramePacer->WaitForNextFrame();
+    }
+    int swapInterval = m_FramePacer->GetSwapInterval();
+    if (IsRenderThreadEnabled())
+    {
+        m_RenderThread->GetRecordingPacket().swapInterval = swapInterval;
+        m_RenderThread->SubmitFrame();
+        if (m_FlushAfterSubmit)
+            m_RenderThread->Flush();
+    }
+    else
+    {
+        m_Present(this, swapInterval);
+    }
+    m_FlushAfterSubmit = false;
+    if (paced)
+        m_FramePacer->EndFrame();
+}
+
+void Application::SetHeadlessContextCurrent(void* app, bool current)
+{
+    HeadlessContext* context = static_cast<Application*>(app)->m_HeadlessContext;
+    if (current)
+        context->MakeCurrent();
+    else
+        context->ReleaseCurrent();
+}
+
+void Application::PresentHeadless(void* app, int swapInterval)
+{
+    // 没有交换缓冲，等GPU画完这一帧，帧时间包含GPU（软件渲染时即光栅化）的时间
+    (void)app;
+    (void)swapInterval;
+    glFinish();
+}
+
+// 已排序数组的分位数（最近秩）
+static double Percentile(const std::vector<double>& sorted, double p)
+{
+    size_t index = static_cast<size_t>(p * (sorted.size() - 1) + 0.5);
+    return sorted[std::min(index, sorted.size() - 1)];
+}
+
+static void PrintFrameStats(const char* label, std::vector<double>& milliseconds)
+{
+    std::sort(milliseconds.begin(), milliseconds.end());
+    double total = 0.0;
+    for (size_t i = 0; i < milliseconds.size(); ++i)
+        total += milliseconds[i];
+    double average = total / milliseconds.size();
+    std::printf("%-6s avg %8.3f  min %8.3f  p50 %8.3f  p95 %8.3f  p99 %8.3f  max %8.3f ms\n", label, average,
+        milliseconds.front(), Percentile(milliseconds, 0.5), Percentile(milliseconds, 0.95), Percentile(milliseconds, 0.99), milliseconds.back());
+}
+
+bool Application::RunHeadless(int frameCount, int warmupFrames)
+{
+    if (frameCount <= 0)
+        return false;
+
+    HeadlessContext context;
+    if (!context.Create(m_Width, m_Height))
+        return false;
+    std::cout << "无头模式: " << glGetString(GL_RENDERER) << " | " << glGetString(GL_VERSION)
+        << "，" << m_Width << "x" << m_Height << std::endl;
+    m_HeadlessContext = &context;
+    m_SetContextCurrent = &Application::SetHeadlessContextCurrent;
+    m_Present = &Application::PresentHeadless;
+
+    GetProfiler().SetThreadName("Main");
+    StartEngine();
+
+    // 帧时间数组提前分配好，不计入每帧的堆分配
+    std::vector<double> cpuMilliseconds(frameCount);
+    std::vector<double> frameMilliseconds(frameCount);
+    size_t allocationFrames = 0;
+    double waitMilliseconds = 0.0;
+    double replayMilliseconds = 0.0;
+
+    typedef std::chrono::steady_clock Clock;
+    Clock::time_point last = Clock::now();
+    for (int frame = -warmupFrames; frame < frameCount; ++frame)
+    {
+        Clock::time_point start = Clock::now();
+        double deltaTime = std::chrono::duration<double>(start - last).count();
+        last = start;
+
+        GetProfiler().MarkFrame();
+        PROFILE_ZONE("Frame");
+        BeginEngineFrame();
+        UpdateAndRender(deltaTime);
+        EndEngineFrame();
+        Clock::time_point submitted = Clock::now();
+
+        // 单线程模式下这里glFinish；渲染线程模式下只提交数据包，GPU的时间体现在下一帧BeginEngineFrame的等待里
+        PresentFrame(false);
+        Clock::time_point finished = Clock::now();
+
+        if (frame < 0)
+            continue;
+        cpuMilliseconds[frame] = std::chrono::duration<double, std::milli>(submitted - start).count();
+        frameMilliseconds[frame] = std::chrono::duration<double, std::milli>(finished - start).count();
+        if (m_FrameAllocationCount > 0)
+            ++allocationFrames;
+        if (IsRenderThreadEnabled())
+        {
+            waitMilliseconds += m_RenderThread->GetWaitMilliseconds();
+            replayMilliseconds += m_RenderThread->GetReplayMilliseconds();
+        }
+    }
+
+    bool threaded = IsRenderThreadEnabled();
+    StopRenderThread();
+    GLenum error = glGetError();
+    StopEngine();
+    m_HeadlessContext = nullptr;
+
+    std::printf("帧数 %d（另有预热 %d 帧），有堆分配的帧 %zu\n", frameCount, warmupFrames, allocationFrames);
+    PrintFrameStats("cpu", cpuMilliseconds);
+    PrintFrameStats("frame", frameMilliseconds);
+    if (threaded)
+        std::printf("渲染线程: 主线程等待平均 %.3f ms，回放平均 %.3f ms\n", waitMilliseconds / frameCount, replayMilliseconds / frameCount);
+    if (error != GL_NO_ERROR)
+        std::printf("GL错误 0x%x\n", error);
+    return error == GL_NO_ERROR;
+}
\ No newline at end of file
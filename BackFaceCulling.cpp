@@ -0,0 +1,130 @@
+﻿#include "BackFaceCulling.h"
+#include "Math/MathKernels.h"
+#include "Core/JobSystem.h"
+#include "Core/FrameAllocator.h"
+#include <cstring>
+
+// 具体实现按指令集分派，见MathKernels*.cpp
+
+size_t CullBackFaces(const Vector3* worldVertices, const uint32_t* indices, size_t triangleCount, uint16_t* output)
+{
+    return GetMathKernels().cullBackFaces16(worldVertices, indices, triangleCount, output);
+}
+
+size_t CullBackFaces(const Vector3* worldVertices, const uint32_t* indices, size_t triangleCount, uint32_t* output)
+{
+    return GetMathKernels().cullBackFaces32(worldVertices, indices, triangleCount, output);
+}
+
+size_t TransformAndCull(const Mat4& matrix, const Vector3* modelVertices, Vector3* worldVertices, size_t vertexCount,
+    const uint32_t* indices, size_t triangleCount, uint16_t* output)
+{
+    const MathKernels& kernels = GetMathKernels();
+    kernels.transformVector3(matrix.Data(), modelVertices, worldVertices, vertexCount, 1.0f);
+    return kernels.cullBackFaces16(worldVertices, indices, triangleCount, output);
+}
+
+size_t TransformAndCull(const Mat4& matrix, const Vector3* modelVertices, Vector3* worldVertices, size_t vertexCount,
+    const uint32_t* indices, size_t triangleCount, uint32_t* output)
+{
+    const MathKernels& kernels = GetMathKernels();
+    kernels.transformVector3(matrix.Data(), modelVertices, worldVertices, vertexCount, 1.0f);
+    return kernels.cullBackFaces32(worldVertices, indices, triangleCount, output);
+}
+
+// ============ 多线程版本 ============
+
+// 每块至少这么多顶点/三角形，块太小时调度开销比计算还大
+static const size_t kMinVertexChunk = 16384;
+static const size_t kMinTriangleChunk = 16384;
+
+// 按线程数把count切成约4倍线程数的块（方便工作窃取做负载均衡），每块不小于minChunk
+static size_t ChunkSize(const JobSystem& jobSystem, size_t count, size_t minChunk)
+{
+    size_t chunkCount = static_cast<size_t>(jobSystem.GetThreadCount()) * 4;
+    size_t chunkSize = (count + chunkCount - 1) / chunkCount;
+    return chunkSize > minChunk ? chunkSize : minChunk;
+}
+
+static size_t CullChunk(const MathKernels& kernels, const Vector3* vertices, const uint32_t* indices, size_t count, uint16_t* output)
+{
+    return kernels.cullBackFaces16(vertices, indices, count, output);
+}
+
+static size_t CullChunk(const MathKernels& kernels, const Vector3* vertices, const uint32_t* indices, size_t count, uint32_t* output)
+{
+    return kernels.cullBackFaces32(vertices, indices, count, output);
+}
+
+template<typename Index>
+static size_t ParallelTransformAndCullImpl(JobSystem& jobSystem, LinearAllocator& scratch,
+    const Mat4& matrix, const Vector3* modelVertices, Vector3* worldVertices, size_t vertexCount,
+    const uint32_t* indices, size_t triangleCount, Index* output)
+{
+    const MathKernels& kernels = GetMathKernels();
+
+    // 1. 变换顶点
+    const float* m = matrix.Data();
+    jobSystem.ParallelFor(vertexCount, ChunkSize(jobSystem, vertexCount, kMinVertexChunk), [&](size_t begin, size_t end) {
+        kernels.transformVector3(m, modelVertices + begin, worldVertices + begin, end - begin, 1.0f);
+    });
+
+    if (triangleCount == 0)
+        return 0;
+
+    // 2. 分块剔除到中间缓冲。块的划分只和三角形数、线程数有关，按块下标遍历，
+    //    单线程时ParallelFor把整个范围交给一次调用，也能得到同样的分块
+    size_t chunkSize = ChunkSize(jobSystem, triangleCount, kMinTriangleChunk);
+    size_t chunkCount = (triangleCount + chunkSize - 1) / chunkSize;
+    Index* scratchIndices = scratch.AllocateArray<Index>(triangleCount * 3);
+    size_t* chunkCounts = scratch.AllocateArray<size_t>(chunkCount);
+    if (!scratchIndices || !chunkCounts)
+    {
+        // 帧分配器容量不够时退回单线程剔除，直接写output，结果相同，只是慢一些
+        return CullChunk(kernels, worldVertices, indices, triangleCount, output);
+    }
+
+    jobSystem.ParallelFor(chunkCount, 1, [&](size_t firstChunk, size_t lastChunk) {
+        for (size_t chunk = firstChunk; chunk < lastChunk; ++chunk)
+        {
+            size_t begin = chunk * chunkSize;
+            size_t count = (triangleCount - begin > chunkSize) ? chunkSize : triangleCount - begin;
+            chunkCounts[chunk] = CullChunk(kernels, worldVertices, indices + begin * 3, count, scratchIndices + begin * 3);
+        }
+    });
+
+    // 3. 前缀和得到每块在output中的起始位置，再并行拷贝
+    size_t total = 0;
+    for (size_t chunk = 0; chunk < chunkCount; ++chunk)
+    {
+        size_t count = chunkCounts[chunk];
+        chunkCounts[chunk] = total;
+        total += count;
+    }
+
+    jobSystem.ParallelFor(chunkCount, 1, [&](size_t firstChunk, size_t lastChunk) {
+        for (size_t chunk = firstChunk; chunk < lastChunk; ++chunk)
+        {
+            size_t end = (chunk + 1 < chunkCount) ? chunkCounts[chunk + 1] : total;
+            std::memcpy(output + chunkCounts[chunk], scratchIndices + chunk * chunkSize * 3,
+                (end - chunkCounts[chunk]) * sizeof(Index));
+        }
+    });
+    return total;
+}
+
+size_t ParallelTransformAndCull(JobSystem& jobSystem, LinearAllocator& scratch, const Mat4& matrix,
+    const Vector3* modelVertices, Vector3* worldVertices, size_t vertexCount,
+    const uint32_t* indices, size_t triangleCount, uint16_t* output)
+{
+    return ParallelTransformAndCullImpl(jobSystem, scratch, matrix,
+        modelVertices, worldVertices, vertexCount, indices, triangleCount, output);
+}
+
+size_t ParallelTransformAndCull(JobSystem& jobSystem, LinearAllocator& scratch, const Mat4& matrix,
+    const Vector3* modelVertices, Vector3* worldVertices, size_t vertexCount,
+    const uint32_t* indices, size_t triangleCount, uint32_t* output)
+{
+    return ParallelTransformAndCullImpl(jobSystem, scratch, matrix,
+        modelVertices, worldVertices, vertexCount, indices, triangleCount, output);
+}
\ No newline at end of file
@@ -0,0 +1,34 @@
+﻿#pragma once
+#include <cstdint>
+#include <cstddef>
+#include "Vector3.h"
+#include "Math/Mat4.h"
+
+class JobSystem;
+class LinearAllocator;
+
+// 背面剔除：只保留 (b - a) x (c - a) 的z分量小于0（朝向屏幕）的三角形
+// 只比较符号，不需要归一化法向量
+// 可见三角形的索引按原顺序紧密写入output，output至少要有 triangleCount * 3 个元素的空间
+// 返回写入的索引个数
+size_t CullBackFaces(const Vector3* worldVertices, const uint32_t* indices, size_t triangleCount, uint16_t* output);
+size_t CullBackFaces(const Vector3* worldVertices, const uint32_t* indices, size_t triangleCount, uint32_t* output);
+
+// 变换+剔除：先把vertexCount个唯一顶点变换到worldVertices，再对三角形做背面剔除
+// 索引网格中一个顶点被约6个三角形共享，所以按顶点变换一次，而不是按三角形重复变换
+size_t TransformAndCull(const Mat4& matrix, const Vector3* modelVertices, Vector3* worldVertices, size_t vertexCount,
+    const uint32_t* indices, size_t triangleCount, uint16_t* output);
+size_t TransformAndCull(const Mat4& matrix, const Vector3* modelVertices, Vector3* worldVertices, size_t vertexCount,
+    const uint32_t* indices, size_t triangleCount, uint32_t* output);
+
+// TransformAndCull的多线程版本，结果与单线程完全一致（可见三角形保持原顺序）
+// 1. 顶点按块分给各线程变换
+// 2. 三角形按块分给各线程，各自剔除到中间缓冲里互不重叠的区间（中间缓冲从scratch分配，通常是帧分配器）
+// 3. 对每块的可见索引数做前缀和，各线程把自己的块拷贝到output的对应位置
+// output可以是映射的GPU缓冲：只写不读，连续写入
+size_t ParallelTransformAndCull(JobSystem& jobSystem, LinearAllocator& scratch, const Mat4& matrix,
+    const Vector3* modelVertices, Vector3* worldVertices, size_t vertexCount,
+    const uint32_t* indices, size_t triangleCount, uint16_t* output);
+size_t ParallelTransformAndCull(JobSystem& jobSystem, LinearAllocator& scratch, const Mat4& matrix,
+    const Vector3* modelVertices, Vector3* worldVertices, size_t vertexCount,
+    const uint32_t* indices, size_t triangleCount, uint32_t* output);
\ No newline at end of file
@@ -0,0 +1,128 @@
+﻿#include "CookedMesh.h"
+#include "Core/Profiler.h"
+#include <filesystem>
+#include <fstream>
+#include <cstring>
+
+static_assert(sizeof(CookedMeshHeader) == 96, "CookedMeshHeader布局变化时需要提升CookedMeshVersion");
+static_assert(sizeof(Vector3) == 3 * sizeof(float), "顶点流按float3直接映射为Vector3");
+
+static inline uint64_t AlignTo16(uint64_t value)
+{
+    return (value + 15) & ~static_cast<uint64_t>(15);
+}
+
+std::string GetCookedMeshPath(const std::string& sourcePath)
+{
+    std::filesystem::path path(sourcePath);
+    path.replace_extension(".cmesh");
+    return path.string();
+}
+
+bool GetCookedMeshSourceStamp(const std::string& sourcePath, CookedMeshSourceStamp& stamp)
+{
+    std::error_code ec;
+    uintmax_t size = std::filesystem::file_size(sourcePath, ec);
+    if (ec) return false;
+
+    std::filesystem::file_time_type writeTime = std::filesystem::last_write_time(sourcePath, ec);
+    if (ec) return false;
+
+    stamp.size = static_cast<uint64_t>(size);
+    stamp.writeTime = static_cast<int64_t>(writeTime.time_since_epoch().count());
+    return true;
+}
+
+bool IsCookedMeshFresh(const CookedMeshHeader& header, const CookedMeshSourceStamp& stamp)
+{
+    return header.sourceSize == stamp.size && header.sourceWriteTime == stamp.writeTime;
+}
+
+const CookedMeshHeader* ValidateCookedMesh(const char* data, size_t size)
+{
+    if (data == nullptr || size < sizeof(CookedMeshHeader))
+        return nullptr;
+
+    const CookedMeshHeader* header = reinterpret_cast<const CookedMeshHeader*>(data);
+    if (header->magic != CookedMeshMagic || header->version != CookedMeshVersion ||
+        header->headerSize != sizeof(CookedMeshHeader) || header->parserVersion != CookedMeshParserVersion)
+        return nullptr;
+
+    if (header->vertexStride != sizeof(Vector3) || header->indexSize != sizeof(uint32_t))
+        return nullptr;
+
+    // 数据流必须完整落在文件内（先除后比，避免乘法溢出）
+    if (header->vertexOffset > size || header->indexOffset > size)
+        return nullptr;
+    if (header->vertexCount > (size - header->vertexOffset) / header->vertexStride)
+        return nullptr;
+    if (header->indexCount > (size - header->indexOffset) / header->indexSize)
+        return nullptr;
+
+    // 索引越界会在剔除内核里变成越界读取，加载时扫描一遍；与max比较没有分支，编译器可以向量化
+    if (header->indexOffset % sizeof(uint32_t) != 0)
+        return nullptr;
+    const uint32_t* indices = reinterpret_cast<const uint32_t*>(data + header->indexOffset);
+    uint32_t maxIndex = 0;
+    for (uint64_t i = 0; i < header->indexCount; ++i)
+        maxIndex = indices[i] > maxIndex ? indices[i] : maxIndex;
+    if (header->indexCount > 0 && maxIndex >= header->vertexCount)
+        return nullptr;
+
+    return header;
+}
+
+bool WriteCookedMesh(const std::string& cookedPath,
+    const Vector3* vertices, size_t vertexCount,
+    const uint32_t* indices, size_t indexCount,
+    const Vector3& boundsMin, const Vector3& boundsMax,
+    const CookedMeshSourceStamp& source)
+{
+    PROFILE_ZONE("WriteCookedMesh");
+    CookedMeshHeader header;
+    std::memset(&header, 0, sizeof(header));
+    header.magic = CookedMeshMagic;
+    header.version = CookedMeshVersion;
+    header.headerSize = sizeof(CookedMeshHeader);
+    header.parserVersion = CookedMeshParserVersion;
+    header.vertexCount = vertexCount;
+    header.vertexStride = sizeof(Vector3);
+    header.vertexOffset = AlignTo16(sizeof(CookedMeshHeader));
+    header.indexCount = indexCount;
+    header.indexSize = sizeof(uint32_t);
+    header.indexOffset = AlignTo16(header.vertexOffset + vertexCount * sizeof(Vector3));
+    header.boundsMin[0] = boundsMin.x; header.boundsMin[1] = boundsMin.y; header.boundsMin[2] = boundsMin.z;
+    header.boundsMax[0] = boundsMax.x; header.boundsMax[1] = boundsMax.y; header.boundsMax[2] = boundsMax.z;
+    header.sourceSize = source.size;
+    header.sourceWriteTime = source.writeTime;
+
+    std::string tempPath = cookedPath + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open())
+            return false;
+
+        static const char padding[16] = {};
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(padding, header.vertexOffset - sizeof(header));
+        file.write(reinterpret_cast<const char*>(vertices), vertexCount * sizeof(Vector3));
+        file.write(padding, header.indexOffset - (header.vertexOffset + vertexCount * sizeof(Vector3)));
+        file.write(reinterpret_cast<const char*>(indices), indexCount * sizeof(uint32_t));
+        if (!file.good())
+        {
+            file.close();
+            std::error_code ec;
+            std::filesystem::remove(tempPath, ec);
+            return false;
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(tempPath, cookedPath, ec);
+    if (ec)
+    {
+        std::filesystem::remove(tempPath, ec);
+        return false;
+    }
+    return true;
+}
\ No newline at end of file
@@ -0,0 +1,69 @@
+﻿#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include "Vector3.h"
+
+// 烘焙网格缓存(.cmesh)：OBJ首次加载后写在源文件旁边，之后直接映射使用
+//
+// 文件布局（小端）：
+//   CookedMeshHeader
+//   顶点流：vertexCount个float3位置，紧密排列
+//   索引流：indexCount个索引，每个indexSize字节
+// 各数据流起始位置按16字节对齐，映射后可直接交给glBufferData
+
+const uint32_t CookedMeshMagic = 0x48534D43;  // "CMSH"
+const uint32_t CookedMeshVersion = 2;
+// OBJ解析器的版本，解析或三角化的输出变化时提升，旧解析器写出的缓存会被重新解析
+//   1：只输出四边形面（拆成两个三角形），三角形和多边形面被静默丢弃，坏角点单独跳过
+//   2：任意边数的面经TriangulatePolygon三角化，含坏角点的面整个丢弃
+const uint32_t CookedMeshParserVersion = 2;
+
+struct CookedMeshHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t headerSize;
+    uint32_t parserVersion;  // 写出时的CookedMeshParserVersion
+
+    uint64_t vertexCount;
+    uint64_t vertexOffset;   // 顶点流相对文件头的偏移
+    uint32_t vertexStride;   // 每个顶点的字节数
+    uint32_t indexSize;      // 每个索引的字节数
+
+    uint64_t indexCount;
+    uint64_t indexOffset;    // 索引流相对文件头的偏移
+
+    float boundsMin[3];      // 包围盒
+    float boundsMax[3];
+
+    uint64_t sourceSize;        // 烘焙时源文件的大小和修改时间，加载时必须完全一致
+    int64_t sourceWriteTime;
+};
+
+// 源文件的大小和修改时间：换成更旧的文件（拷贝、从版本库恢复）时修改时间也会变，按相等比较
+struct CookedMeshSourceStamp
+{
+    uint64_t size;
+    int64_t writeTime;
+};
+
+// 源文件路径对应的缓存路径：block.obj -> block.cmesh
+std::string GetCookedMeshPath(const std::string& sourcePath);
+
+// 读取源文件的大小和修改时间，源文件不存在时返回false
+bool GetCookedMeshSourceStamp(const std::string& sourcePath, CookedMeshSourceStamp& stamp);
+
+// 缓存记录的源文件大小和修改时间与stamp完全一致时返回true
+bool IsCookedMeshFresh(const CookedMeshHeader& header, const CookedMeshSourceStamp& stamp);
+
+// 校验映射进来的缓存数据，合法时返回文件头，否则返回nullptr
+// 除文件头和数据流范围外还会扫描一遍索引流，任何索引不小于vertexCount都视为损坏
+const CookedMeshHeader* ValidateCookedMesh(const char* data, size_t size);
+
+// 写出缓存，先写临时文件再重命名，避免其他进程读到写了一半的文件
+bool WriteCookedMesh(const std::string& cookedPath,
+    const Vector3* vertices, size_t vertexCount,
+    const uint32_t* indices, size_t indexCount,
+    const Vector3& boundsMin, const Vector3& boundsMax,
+    const CookedMeshSourceStamp& source);
\ No newline at end of file
@@ -0,0 +1,184 @@
+﻿#include "Core/CpuFeatures.h"
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define CENGINE_CPU_X86 1
+#elif defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#define CENGINE_CPU_X86 1
+#endif
+
+#ifdef CENGINE_CPU_X86
+
+static void QueryCpuid(unsigned int leaf, unsigned int subleaf, unsigned int regs[4])
+{
+#ifdef _MSC_VER
+    int info[4];
+    __cpuidex(info, static_cast<int>(leaf), static_cast<int>(subleaf));
+    for (int i = 0; i < 4; ++i)
+        regs[i] = static_cast<unsigned int>(info[i]);
+#else
+    __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+
+// XCR0：操作系统在上下文切换时保存了哪些寄存器
+static unsigned long long ReadXcr0()
+{
+#ifdef _MSC_VER
+    return _xgetbv(0);
+#else
+    unsigned int eax, edx;
+    __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return (static_cast<unsigned long long>(edx) << 32) | eax;
+#endif
+}
+
+static CpuFeatures DetectCpuFeatures()
+{
+    CpuFeatures features;
+    unsigned int regs[4] = {};
+
+    QueryCpuid(0, 0, regs);
+    unsigned int maxLeaf = regs[0];
+    if (maxLeaf < 1)
+        return features;
+
+    // 1. leaf 1：SSE系列、AVX、FMA、OSXSAVE
+    QueryCpuid(1, 0, regs);
+    unsigned int ecx = regs[2];
+    unsigned int edx = regs[3];
+    features.sse2 = (edx & (1u << 26)) != 0;
+    features.sse41 = (ecx & (1u << 19)) != 0;
+    features.sse42 = (ecx & (1u << 20)) != 0;
+
+    // 2. AVX需要操作系统保存XMM和YMM（XCR0第1、2位）
+    bool osxsave = (ecx & (1u << 27)) != 0;
+    unsigned long long xcr0 = osxsave ? ReadXcr0() : 0;
+    bool ymmEnabled = (xcr0 & 0x6) == 0x6;
+    bool zmmEnabled = (xcr0 & 0xE6) == 0xE6;
+    features.avx = ymmEnabled && (ecx & (1u << 28)) != 0;
+    features.fma = features.avx && (ecx & (1u << 12)) != 0;
+
+    // 3. leaf 7：AVX2、AVX-512F
+    if (maxLeaf >= 7)
+    {
+        QueryCpuid(7, 0, regs);
+        features.avx2 = features.avx && (regs[1] & (1u << 5)) != 0;
+        features.avx512f = zmmEnabled && (regs[1] & (1u << 16)) != 0;
+    }
+
+    // 4. 扩展leaf 0x80000007：不变TSC（EDX第8位）
+    QueryCpuid(0x80000000, 0, regs);
+    if (regs[0] >= 0x80000007)
+    {
+        QueryCpuid(0x80000007, 0, regs);
+        features.invariantTsc = (regs[3] & (1u << 8)) != 0;
+    }
+    return features;
+}
+
+#else
+
+static CpuFeatures DetectCpuFeatures()
+{
+    return CpuFeatures();
+}
+
+#endif
+
+const CpuFeatures& GetCpuFeatures()
+{
+    static const CpuFeatures features = DetectCpuFeatures();
+    return features;
+}
+
+SimdLevel GetSupportedSimdLevel()
+{
+    const CpuFeatures& features = GetCpuFeatures();
+    if (features.avx2 && features.fma)
+        return SimdLevel::AVX2;
+    if (features.sse2)
+        return SimdLevel::SSE2;
+    return SimdLevel::Scalar;
+}
+
+static SimdLevel ClampToSupported(SimdLevel level)
+{
+    SimdLevel supported = GetSupportedSimdLevel();
+    return level > supported ? supported : level;
+}
+
+static SimdLevel InitialSimdLevel()
+{
+    SimdLevel level = GetSupportedSimdLevel();
+
+    const char* env = std::getenv("CENGINE_SIMD");
+    if (env && *env)
+    {
+        SimdLevel requested;
+        if (!ParseSimdLevel(env, requested))
+        {
+            std::cerr << "CENGINE_SIMD取值无效: " << env << "，可选 scalar/sse2/avx2" << std::endl;
+        }
+        else
+        {
+            level = ClampToSupported(requested);
+            if (level != requested)
+                std::cerr << "本机不支持" << GetSimdLevelName(requested) << "，改用" << GetSimdLevelName(level) << std::endl;
+        }
+    }
+    return level;
+}
+
+// 控制窗口在运行中切换档位，工作线程同时在读，用原子变量
+static std::atomic<SimdLevel>& ActiveSimdLevel()
+{
+    static std::atomic<SimdLevel> level(InitialSimdLevel());
+    return level;
+}
+
+SimdLevel GetActiveSimdLevel()
+{
+    return ActiveSimdLevel().load(std::memory_order_relaxed);
+}
+
+SimdLevel SetSimdLevelOverride(SimdLevel level)
+{
+    SimdLevel clamped = ClampToSupported(level);
+    ActiveSimdLevel().store(clamped, std::memory_order_relaxed);
+    return clamped;
+}
+
+const char* GetSimdLevelName(SimdLevel level)
+{
+    switch (level)
+    {
+    case SimdLevel::AVX2: return "AVX2";
+    case SimdLevel::SSE2: return "SSE2";
+    default: return "Scalar";
+    }
+}
+
+static bool EqualsIgnoreCase(const char* a, const char* b)
+{
+    for (; *a && *b; ++a, ++b)
+    {
+        char ca = (*a >= 'A' && *a <= 'Z') ? static_cast<char>(*a - 'A' + 'a') : *a;
+        char cb = (*b >= 'A' && *b <= 'Z') ? static_cast<char>(*b - 'A' + 'a') : *b;
+        if (ca != cb)
+            return false;
+    }
+    return *a == *b;
+}
+
+bool ParseSimdLevel(const char* name, SimdLevel& level)
+{
+    if (EqualsIgnoreCase(name, "scalar")) { level = SimdLevel::Scalar; return true; }
+    if (EqualsIgnoreCase(name, "sse2")) { level = SimdLevel::SSE2; return true; }
+    if (EqualsIgnoreCase(name, "avx2")) { level = SimdLevel::AVX2; return true; }
+    return false;
+}
\ No newline at end of file
@@ -0,0 +1,92 @@
+﻿#include "Core/FrameAllocator.h"
+#include <cstdint>
+#include <cstdlib>
+
+// 对齐到alignment的整数倍（alignment为2的幂）
+static uintptr_t AlignUp(uintptr_t value, size_t alignment)
+{
+    return (value + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1);
+}
+
+LinearAllocator::LinearAllocator(size_t capacity)
+    : m_Buffer(nullptr), m_Capacity(0), m_Offset(0), m_OverflowBytes(0), m_Peak(0), m_OverflowCount(0)
+{
+    if (capacity > 0)
+    {
+        m_Buffer = static_cast<char*>(std::malloc(capacity));
+        if (m_Buffer)
+            m_Capacity = capacity;
+    }
+}
+
+LinearAllocator::~LinearAllocator()
+{
+    for (void* block : m_Overflow)
+        std::free(block);
+    std::free(m_Buffer);
+}
+
+void* LinearAllocator::Allocate(size_t size, size_t alignment)
+{
+    if (size == 0)
+        size = 1;
+
+    // 按绝对地址对齐，m_Buffer本身只保证malloc的默认对齐
+    if (m_Buffer)
+    {
+        uintptr_t base = reinterpret_cast<uintptr_t>(m_Buffer);
+        size_t offset = static_cast<size_t>(AlignUp(base + m_Offset, alignment) - base);
+        if (offset <= m_Capacity && size <= m_Capacity - offset)
+        {
+            m_Offset = offset + size;
+            return m_Buffer + offset;
+        }
+    }
+
+    // 溢出：单独申请一块，多申请alignment字节用来对齐
+    char* block = static_cast<char*>(std::malloc(size + alignment));
+    if (!block)
+        return nullptr;
+    m_Overflow.push_back(block);
+    m_OverflowBytes += size + alignment;
+    ++m_OverflowCount;
+    return reinterpret_cast<void*>(AlignUp(reinterpret_cast<uintptr_t>(block), alignment));
+}
+
+void LinearAllocator::Reset()
+{
+    size_t used = GetUsed();
+    if (used > m_Peak)
+        m_Peak = used;
+
+    for (void* block : m_Overflow)
+        std::free(block);
+    m_Overflow.clear();
+
+    // 本轮溢出过：按峰值加1/4余量重新分配，之后同样大小的一轮不再溢出
+    if (m_OverflowBytes > 0)
+    {
+        size_t capacity = m_Peak + m_Peak / 4;
+        char* buffer = static_cast<char*>(std::malloc(capacity));
+        if (buffer)
+        {
+            std::free(m_Buffer);
+            m_Buffer = buffer;
+            m_Capacity = capacity;
+        }
+    }
+
+    m_Offset = 0;
+    m_OverflowBytes = 0;
+}
+
+FrameAllocator::FrameAllocator(size_t capacityPerFrame)
+    : m_Arenas{ LinearAllocator(capacityPerFrame), LinearAllocator(capacityPerFrame) }, m_Current(0)
+{
+}
+
+void FrameAllocator::BeginFrame()
+{
+    m_Current = 1 - m_Current;
+    m_Arenas[m_Current].Reset();
+}
\ No newline at end of file
@@ -0,0 +1,132 @@
+﻿#include "Core/FramePacer.h"
+#include <cmath>
+#include <thread>
+
+FramePacer::FramePacer()
+    : m_Mode(PresentMode::VSync), m_TargetRate(60.0), m_AdaptiveSupported(true),
+    m_DeadlineValid(false), m_SleepOvershoot(0.001), m_LastFrameValid(false)
+{
+    ResetStats();
+}
+
+const char* FramePacer::GetModeName(PresentMode mode)
+{
+    switch (mode)
+    {
+    case PresentMode::Uncapped: return "Uncapped";
+    case PresentMode::VSync: return "VSync";
+    case PresentMode::AdaptiveVSync: return "Adaptive VSync";
+    case PresentMode::Limited: return "Frame Limiter";
+    default: return "Unknown";
+    }
+}
+
+void FramePacer::SetMode(PresentMode mode)
+{
+    if (mode == m_Mode || mode >= PresentMode::Count)
+        return;
+    m_Mode = mode;
+    m_DeadlineValid = false;
+    ResetStats();
+}
+
+void FramePacer::SetTargetRate(double framesPerSecond)
+{
+    if (framesPerSecond < 1.0) framesPerSecond = 1.0;
+    if (framesPerSecond > 1000.0) framesPerSecond = 1000.0;
+    if (framesPerSecond == m_TargetRate)
+        return;
+    m_TargetRate = framesPerSecond;
+    m_DeadlineValid = false;
+    ResetStats();
+}
+
+int FramePacer::GetSwapInterval() const
+{
+    switch (m_Mode)
+    {
+    case PresentMode::VSync: return 1;
+    case PresentMode::AdaptiveVSync: return m_AdaptiveSupported ? -1 : 1;
+    default: return 0;
+    }
+}
+
+void FramePacer::WaitForNextFrame()
+{
+    if (m_Mode != PresentMode::Limited)
+        return;
+
+    Clock::duration period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / m_TargetRate));
+    Clock::time_point now = Clock::now();
+    if (!m_DeadlineValid)
+    {
+        m_Deadline = now;
+        m_DeadlineValid = true;
+    }
+    m_Deadline += period;
+
+    // 已经晚于截止时间（这一帧本身就超过了周期）：不等待，从现在重新计时，不连续补帧
+    if (m_Deadline <= now)
+    {
+        m_Deadline = now;
+        return;
+    }
+
+    // 剩余时间超过估计的超时才sleep，只sleep到估计超时之前
+    double remaining = std::chrono::duration<double>(m_Deadline - now).count();
+    if (remaining > m_SleepOvershoot)
+    {
+        double request = remaining - m_SleepOvershoot;
+        Clock::time_point sleepStart = Clock::now();
+        std::this_thread::sleep_for(std::chrono::duration<double>(request));
+        double overshoot = std::chrono::duration<double>(Clock::now() - sleepStart).count() - request;
+
+        // 超时估计取观测值和缓慢衰减的旧值中较大者：偶尔的长超时会让之后几百帧多自旋一些，但不会错过截止时间
+        m_SleepOvershoot = std::fmax(m_SleepOvershoot * 0.99, overshoot);
+        if (m_SleepOvershoot < 0.0002)
+            m_SleepOvershoot = 0.0002;
+    }
+
+    while (Clock::now() < m_Deadline)
+        std::this_thread::yield();
+}
+
+void FramePacer::EndFrame()
+{
+    Clock::time_point now = Clock::now();
+    if (m_LastFrameValid)
+    {
+        m_Samples[m_NextSample] = std::chrono::duration<double, std::milli>(now - m_LastFrame).count();
+        m_NextSample = (m_NextSample + 1) % SampleCount;
+        if (m_SampleCount < SampleCount)
+            ++m_SampleCount;
+
+        double total = 0.0;
+        for (size_t i = 0; i < m_SampleCount; ++i)
+            total += m_Samples[i];
+        double average = total / m_SampleCount;
+        double variance = 0.0;
+        double maxDeviation = 0.0;
+        for (size_t i = 0; i < m_SampleCount; ++i)
+        {
+            double deviation = m_Samples[i] - average;
+            variance += deviation * deviation;
+            maxDeviation = std::fmax(maxDeviation, std::fabs(deviation));
+        }
+        m_AverageMilliseconds = average;
+        m_JitterMilliseconds = std::sqrt(variance / m_SampleCount);
+        m_MaxDeviationMilliseconds = maxDeviation;
+    }
+    m_LastFrame = now;
+    m_LastFrameValid = true;
+}
+
+void FramePacer::ResetStats()
+{
+    m_SampleCount = 0;
+    m_NextSample = 0;
+    m_AverageMilliseconds = 0.0;
+    m_JitterMilliseconds = 0.0;
+    m_MaxDeviationMilliseconds = 0.0;
+    m_LastFrameValid = false;
+}
\ No newline at end of file
@@ -0,0 +1,28 @@
+﻿#include "Graphics/GLExtensions.h"
+#include <glad/glad.h>
+#include <cstring>
+
+static GLProcLoader s_Loader = nullptr;
+
+void SetGLProcLoader(GLProcLoader loader)
+{
+    s_Loader = loader;
+}
+
+bool IsGLExtensionSupported(const char* name)
+{
+    GLint count = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+    for (GLint i = 0; i < count; ++i)
+    {
+        const char* extension = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, i));
+        if (extension && std::strcmp(extension, name) == 0)
+            return true;
+    }
+    return false;
+}
+
+void* GetGLProcAddress(const char* name)
+{
+    return s_Loader ? s_Loader(name) : nullptr;
+}
\ No newline at end of file
@@ -0,0 +1,252 @@
+﻿#include "Graphics/GLStateCache.h"
+#include <glad/glad.h>
+#include <iostream>
+
+static const GLenum BufferTargets[] = {
+    GL_ARRAY_BUFFER, GL_ELEMENT_ARRAY_BUFFER, GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, GL_UNIFORM_BUFFER
+};
+// glad头文件里没有GL_COPY_READ/WRITE_BUFFER_BINDING，按规范它们与目标枚举同值
+static const GLenum BufferBindings[] = {
+    GL_ARRAY_BUFFER_BINDING, GL_ELEMENT_ARRAY_BUFFER_BINDING, GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, GL_UNIFORM_BUFFER_BINDING
+};
+static const GLenum Capabilities[] = {
+    GL_DEPTH_TEST, GL_CULL_FACE, GL_BLEND, GL_SCISSOR_TEST, GL_STENCIL_TEST, GL_FRAMEBUFFER_SRGB
+};
+static const GLenum TextureTargets[] = { GL_TEXTURE_2D, GL_TEXTURE_CUBE_MAP };
+static const GLenum TextureBindings[] = { GL_TEXTURE_BINDING_2D, GL_TEXTURE_BINDING_CUBE_MAP };
+
+template<typename T, size_t N>
+static int FindIndex(const T (&values)[N], GLenum value)
+{
+    for (size_t i = 0; i < N; ++i)
+    {
+        if (values[i] == value)
+            return static_cast<int>(i);
+    }
+    return -1;
+}
+
+GLStateCache& GetGLStateCache()
+{
+    static GLStateCache cache;
+    return cache;
+}
+
+GLStateCache::GLStateCache()
+    : m_Issued(0), m_Redundant(0), m_LastIssued(0), m_LastRedundant(0), m_MismatchCount(0)
+{
+#ifdef NDEBUG
+    m_Validate = false;
+#else
+    m_Validate = true;
+#endif
+    Invalidate();
+}
+
+void GLStateCache::Invalidate()
+{
+    m_Program = Unknown;
+    m_VertexArray = Unknown;
+    for (unsigned int& buffer : m_Buffers)
+        buffer = Unknown;
+    for (unsigned int& capability : m_Capabilities)
+        capability = Unknown;
+    m_ActiveTexture = Unknown;
+    for (int unit = 0; unit < TextureUnitCount; ++unit)
+    {
+        for (int target = 0; target < TextureTargetCount; ++target)
+            m_Textures[unit][target] = Unknown;
+    }
+    m_FrontFace = Unknown;
+    m_CullFace = Unknown;
+}
+
+void GLStateCache::BeginFrame()
+{
+    m_LastIssued = m_Issued;
+    m_LastRedundant = m_Redundant;
+    m_Issued = 0;
+    m_Redundant = 0;
+}
+
+bool GLStateCache::Track(unsigned int& shadow, unsigned int value, unsigned int queryEnum, const char* name)
+{
+    if (m_Validate && shadow != Unknown)
+    {
+        GLint actual = 0;
+        glGetIntegerv(queryEnum, &actual);
+        if (static_cast<unsigned int>(actual) != shadow)
+        {
+            ++m_MismatchCount;
+            std::cerr << "GL状态缓存不一致: " << name << " 记录为 " << shadow << "，实际为 " << actual << std::endl;
+            shadow = static_cast<unsigned int>(actual);
+        }
+    }
+
+    if (shadow == value)
+    {
+        ++m_Redundant;
+        return false;
+    }
+    shadow = value;
+    ++m_Issued;
+    return true;
+}
+
+void GLStateCache::UseProgram(unsigned int program)
+{
+    if (Track(m_Program, program, GL_CURRENT_PROGRAM, "program"))
+        glUseProgram(program);
+}
+
+void GLStateCache::BindVertexArray(unsigned int vao)
+{
+    if (Track(m_VertexArray, vao, GL_VERTEX_ARRAY_BINDING, "vertex array"))
+    {
+        glBindVertexArray(vao);
+        // 索引缓冲的绑定跟着VAO走
+        m_Buffers[1] = Unknown;
+    }
+}
+
+void GLStateCache::BindBuffer(unsigned int target, unsigned int buffer)
+{
+    int index = FindIndex(BufferTargets, target);
+    if (index < 0)
+    {
+        // 不跟踪的目标直接下发
+        ++m_Issued;
+        glBindBuffer(target, buffer);
+        return;
+    }
+    if (Track(m_Buffers[index], buffer, BufferBindings[index], "buffer"))
+        glBindBuffer(target, buffer);
+}
+
+void GLStateCache::ActiveTexture(unsigned int unit)
+{
+    if (Track(m_ActiveTexture, GL_TEXTURE0 + unit, GL_ACTIVE_TEXTURE, "active texture"))
+        glActiveTexture(GL_TEXTURE0 + unit);
+}
+
+void GLStateCache::BindTexture(unsigned int unit, unsigned int target, unsigned int texture)
+{
+    int index = FindIndex(TextureTargets, target);
+    if (index < 0 || unit >= static_cast<unsigned int>(TextureUnitCount))
+    {
+        ++m_Issued;
+        glActiveTexture(GL_TEXTURE0 + unit);
+        m_ActiveTexture = GL_TEXTURE0 + unit;
+        glBindTexture(target, texture);
+        return;
+    }
+
+    // 绑定已经是目标纹理时连glActiveTexture都不用切
+    unsigned int& shadow = m_Textures[unit][index];
+    if (!m_Validate && shadow == texture)
+    {
+        ++m_Redundant;
+        return;
+    }
+    ActiveTexture(unit);
+    if (Track(shadow, texture, TextureBindings[index], "texture"))
+        glBindTexture(target, texture);
+}
+
+void GLStateCache::ValidateCapability(int index, unsigned int capability)
+{
+    unsigned int& shadow = m_Capabilities[index];
+    if (!m_Validate || shadow == Unknown)
+        return;
+    unsigned int actual = glIsEnabled(capability) ? 1u : 0u;
+    if (actual != shadow)
+    {
+        ++m_MismatchCount;
+        std::cerr << "GL状态缓存不一致: capability 0x" << std::hex << capability << std::dec
+            << " 记录为 " << shadow << "，实际为 " << actual << std::endl;
+        shadow = actual;
+    }
+}
+
+void GLStateCache::SetCapability(unsigned int capability, bool enabled)
+{
+    int index = FindIndex(Capabilities, capability);
+    if (index < 0)
+    {
+        ++m_Issued;
+        enabled ? glEnable(capability) : glDisable(capability);
+        return;
+    }
+
+    ValidateCapability(index, capability);
+    unsigned int value = enabled ? 1u : 0u;
+    if (m_Capabilities[index] == value)
+    {
+        ++m_Redundant;
+        return;
+    }
+    m_Capabilities[index] = value;
+    ++m_Issued;
+    enabled ? glEnable(capability) : glDisable(capability);
+}
+
+void GLStateCache::FrontFace(unsigned int mode)
+{
+    if (Track(m_FrontFace, mode, GL_FRONT_FACE, "front face"))
+        glFrontFace(mode);
+}
+
+void GLStateCache::CullFace(unsigned int mode)
+{
+    if (Track(m_CullFace, mode, GL_CULL_FACE_MODE, "cull face"))
+        glCullFace(mode);
+}
+
+void GLStateCache::DeleteProgram(unsigned int program)
+{
+    if (program == 0)
+        return;
+    // 正在使用的程序删除后要到切换时才真正释放，之后名字可能被新程序复用，记录置为未知保证下次一定下发
+    glDeleteProgram(program);
+    if (m_Program == program)
+        m_Program = Unknown;
+}
+
+void GLStateCache::DeleteVertexArray(unsigned int vao)
+{
+    if (vao == 0)
+        return;
+    glDeleteVertexArrays(1, &vao);
+    if (m_VertexArray == vao)
+    {
+        m_VertexArray = 0;
+        m_Buffers[1] = Unknown;
+    }
+}
+
+void GLStateCache::DeleteBuffer(unsigned int buffer)
+{
+    if (buffer == 0)
+        return;
+    glDeleteBuffers(1, &buffer);
+    for (unsigned int& binding : m_Buffers)
+    {
+        if (binding == buffer)
+            binding = 0;
+    }
+}
+
+void GLStateCache::DeleteTexture(unsigned int texture)
+{
+    if (texture == 0)
+        return;
+    glDeleteTextures(1, &texture);
+    for (int unit = 0; unit < TextureUnitCount; ++unit)
+    {
+        for (int target = 0; target < TextureTargetCount; ++target)
+        {
+            if (m_Textures[unit][target] == texture)
+                m_Textures[unit][target] = 0;
+        }
+    }
+}
\ No newline at end of file
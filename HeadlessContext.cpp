@@ -0,0 +1,170 @@
+﻿#include "Graphics/HeadlessContext.h"
+#include "Graphics/GLExtensions.h"
+#include <glad/glad.h>
+#include <iostream>
+
+#ifdef __linux__
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+static void* LoadEGLProc(const char* name)
+{
+    return reinterpret_cast<void*>(eglGetProcAddress(name));
+}
+
+// 优先用Mesa的surfaceless平台，完全不碰X11/Wayland；没有时退回默认显示
+static EGLDisplay OpenDisplay()
+{
+    PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay =
+        reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(eglGetProcAddress("eglGetPlatformDisplayEXT"));
+    if (getPlatformDisplay)
+    {
+        EGLDisplay display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+        if (display != EGL_NO_DISPLAY && eglInitialize(display, nullptr, nullptr))
+            return display;
+    }
+    EGLDisplay display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    if (display != EGL_NO_DISPLAY && eglInitialize(display, nullptr, nullptr))
+        return display;
+    return EGL_NO_DISPLAY;
+}
+#endif
+
+HeadlessContext::HeadlessContext()
+    : m_Display(nullptr), m_Context(nullptr), m_Framebuffer(0), m_ColorBuffer(0), m_DepthBuffer(0), m_Width(0), m_Height(0)
+{
+}
+
+HeadlessContext::~HeadlessContext()
+{
+    Destroy();
+}
+
+bool HeadlessContext::Create(int width, int height)
+{
+#ifdef __linux__
+    EGLDisplay display = OpenDisplay();
+    if (display == EGL_NO_DISPLAY)
+    {
+        std::cerr << "无头模式：EGL初始化失败" << std::endl;
+        return false;
+    }
+    m_Display = display;
+
+    // EGL_SURFACE_TYPE默认要求窗口，这里不创建surface，不限制
+    const EGLint configAttributes[] = { EGL_SURFACE_TYPE, 0, EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT, EGL_NONE };
+    EGLConfig config = nullptr;
+    EGLint configCount = 0;
+    if (!eglChooseConfig(display, configAttributes, &config, 1, &configCount) || configCount == 0)
+    {
+        std::cerr << "无头模式：没有支持桌面OpenGL的EGL配置" << std::endl;
+        Destroy();
+        return false;
+    }
+
+    // 与窗口模式相同，请求3.3 core
+    eglBindAPI(EGL_OPENGL_API);
+    const EGLint contextAttributes[] = {
+        EGL_CONTEXT_MAJOR_VERSION, 3,
+        EGL_CONTEXT_MINOR_VERSION, 3,
+        EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+        EGL_NONE
+    };
+    EGLContext context = eglCreateContext(display, config, EGL_NO_CONTEXT, contextAttributes);
+    if (context == EGL_NO_CONTEXT)
+    {
+        std::cerr << "无头模式：创建GL上下文失败，EGL错误 0x" << std::hex << eglGetError() << std::dec << std::endl;
+        Destroy();
+        return false;
+    }
+    m_Context = context;
+
+    // 不创建任何surface（需要EGL_KHR_surfaceless_context），所有绘制都进FBO
+    if (!eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, context))
+    {
+        std::cerr << "无头模式：驱动不支持surfaceless上下文" << std::endl;
+        Destroy();
+        return false;
+    }
+
+    if (!gladLoadGLLoader((GLADloadproc)LoadEGLProc))
+    {
+        std::cerr << "Failed to initialize GLAD" << std::endl;
+        Destroy();
+        return false;
+    }
+    SetGLProcLoader(LoadEGLProc);
+
+    m_Width = width;
+    m_Height = height;
+    glGenRenderbuffers(1, &m_ColorBuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, m_ColorBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+    glGenRenderbuffers(1, &m_DepthBuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, m_DepthBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    glGenFramebuffers(1, &m_Framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, m_Framebuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, m_ColorBuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, m_DepthBuffer);
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+    {
+        std::cerr << "无头模式：离屏FBO不完整" << std::endl;
+        Destroy();
+        return false;
+    }
+    glViewport(0, 0, width, height);
+    return true;
+#else
+    (void)width;
+    (void)height;
+    std::cerr << "无头模式只支持Linux（EGL）" << std::endl;
+    return false;
+#endif
+}
+
+bool HeadlessContext::MakeCurrent()
+{
+#ifdef __linux__
+    if (m_Context && eglMakeCurrent(m_Display, EGL_NO_SURFACE, EGL_NO_SURFACE, m_Context))
+        return true;
+    std::cerr << "无头模式：绑定GL上下文失败" << std::endl;
+#endif
+    return false;
+}
+
+void HeadlessContext::ReleaseCurrent()
+{
+#ifdef __linux__
+    if (m_Display)
+        eglMakeCurrent(m_Display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+#endif
+}
+
+void HeadlessContext::Destroy()
+{
+#ifdef __linux__
+    if (m_Context)
+    {
+        // 渲染缓冲不为0说明glad已经加载成功
+        if (m_ColorBuffer)
+        {
+            glBindFramebuffer(GL_FRAMEBUFFER, 0);
+            glDeleteFramebuffers(1, &m_Framebuffer);
+            glDeleteRenderbuffers(1, &m_ColorBuffer);
+            glDeleteRenderbuffers(1, &m_DepthBuffer);
+        }
+        eglMakeCurrent(m_Display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+        eglDestroyContext(m_Display, m_Context);
+    }
+    if (m_Display)
+        eglTerminate(m_Display);
+#endif
+    m_Display = nullptr;
+    m_Context = nullptr;
+    m_Framebuffer = 0;
+    m_ColorBuffer = 0;
+    m_DepthBuffer = 0;
+}
\ No newline at end of file
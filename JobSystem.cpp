@@ -0,0 +1,249 @@
+﻿#include "Core/JobSystem.h"
+#include "Core/Profiler.h"
+#include <cstdio>
+
+// 工作线程的队列编号，非工作线程为-1
+static thread_local int t_QueueIndex = -1;
+
+JobSystem::JobSystem(unsigned int workerCount)
+    : m_QueuedCount(0), m_SleepingCount(0), m_Quit(false),
+    m_ExecutedCount(0), m_StolenCount(0)
+{
+    if (workerCount == 0)
+    {
+        unsigned int hardwareThreads = std::thread::hardware_concurrency();
+        workerCount = hardwareThreads > 1 ? hardwareThreads - 1 : 0;
+    }
+
+    // 0号队列属于主线程，1..workerCount属于工作线程
+    for (unsigned int i = 0; i <= workerCount; ++i)
+        m_Queues.push_back(std::unique_ptr<WorkQueue>(new WorkQueue()));
+
+    for (unsigned int i = 1; i <= workerCount; ++i)
+        m_Workers.emplace_back(&JobSystem::WorkerLoop, this, i);
+}
+
+JobSystem::~JobSystem()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_SleepMutex);
+        m_Quit.store(true);
+    }
+    m_WakeCondition.notify_all();
+    for (std::thread& worker : m_Workers)
+        worker.join();
+}
+
+unsigned int JobSystem::CurrentQueueIndex() const
+{
+    // 工作线程用自己的队列；主线程和其他外部线程都放进0号队列
+    return t_QueueIndex >= 0 ? static_cast<unsigned int>(t_QueueIndex) : 0;
+}
+
+void JobSystem::Run(std::function<void()> job, JobCounter* counter, JobCounter* dependency)
+{
+    if (counter)
+        counter->m_Pending.fetch_add(1, std::memory_order_relaxed);
+
+    // 依赖未完成：挂到依赖的等待列表上，由CompleteJob在它归零时提交
+    // 检查和挂起在同一把锁里，和CompleteJob取走等待列表互斥，不会漏掉
+    if (dependency)
+    {
+        std::lock_guard<std::mutex> lock(dependency->m_WaitingMutex);
+        if (!dependency->IsDone())
+        {
+            dependency->m_Waiting.push_back({ std::move(job), counter });
+            return;
+        }
+    }
+
+    Job entry;
+    entry.function = std::move(job);
+    entry.counter = counter;
+    Push(std::move(entry));
+}
+
+void JobSystem::RunRange(RangeFunction range, const void* context, size_t begin, size_t end, JobCounter* counter)
+{
+    if (counter)
+        counter->m_Pending.fetch_add(1, std::memory_order_relaxed);
+
+    Job entry;
+    entry.range = range;
+    entry.context = context;
+    entry.begin = begin;
+    entry.end = end;
+    entry.counter = counter;
+    Push(std::move(entry));
+}
+
+void JobSystem::WorkQueue::PushBack(Job&& job)
+{
+    if (count == slots.size())
+    {
+        // 满了：按顺序搬到两倍大小的新数组
+        std::vector<Job> grown(slots.empty() ? 64 : slots.size() * 2);
+        for (size_t i = 0; i < count; ++i)
+            grown[i] = std::move(slots[(head + i) % slots.size()]);
+        slots.swap(grown);
+        head = 0;
+    }
+    slots[(head + count) % slots.size()] = std::move(job);
+    ++count;
+}
+
+void JobSystem::WorkQueue::PopBack(Job& job)
+{
+    --count;
+    job = std::move(slots[(head + count) % slots.size()]);
+}
+
+void JobSystem::WorkQueue::PopFront(Job& job)
+{
+    job = std::move(slots[head]);
+    head = (head + 1) % slots.size();
+    --count;
+}
+
+void JobSystem::Push(Job job)
+{
+    WorkQueue& queue = *m_Queues[CurrentQueueIndex()];
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.PushBack(std::move(job));
+    }
+    // 与WorkerLoop中“先登记睡眠再检查任务数”配对，两边都用顺序一致的原子操作，保证至少一方看到对方
+    m_QueuedCount.fetch_add(1);
+
+    // 有线程在睡眠时才需要唤醒，忙碌时不碰条件变量
+    if (m_SleepingCount.load() > 0)
+    {
+        std::lock_guard<std::mutex> lock(m_SleepMutex);
+        m_WakeCondition.notify_one();
+    }
+}
+
+bool JobSystem::TryPop(unsigned int queueIndex, Job& job)
+{
+    WorkQueue& queue = *m_Queues[queueIndex];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.count == 0)
+        return false;
+    queue.PopBack(job);
+    m_QueuedCount.fetch_sub(1, std::memory_order_relaxed);
+    return true;
+}
+
+bool JobSystem::TrySteal(unsigned int thiefIndex, Job& job)
+{
+    // 从下一个队列开始轮询，避免所有线程都去偷同一个队列
+    unsigned int queueCount = static_cast<unsigned int>(m_Queues.size());
+    for (unsigned int offset = 1; offset < queueCount; ++offset)
+    {
+        WorkQueue& queue = *m_Queues[(thiefIndex + offset) % queueCount];
+        std::unique_lock<std::mutex> lock(queue.mutex, std::try_to_lock);
+        if (!lock.owns_lock() || queue.count == 0)
+            continue;
+        queue.PopFront(job);
+        m_QueuedCount.fetch_sub(1, std::memory_order_relaxed);
+        m_StolenCount.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+    return false;
+}
+
+bool JobSystem::TryRunOne(unsigned int queueIndex)
+{
+    Job job;
+    if (!TryPop(queueIndex, job) && !TrySteal(queueIndex, job))
+        return false;
+    Execute(job);
+    return true;
+}
+
+void JobSystem::Execute(Job& job)
+{
+    PROFILE_ZONE("Job");
+    if (job.range)
+        job.range(job.context, job.begin, job.end);
+    else
+        job.function();
+    m_ExecutedCount.fetch_add(1, std::memory_order_relaxed);
+    CompleteJob(job.counter);
+}
+
+void JobSystem::CompleteJob(JobCounter* counter)
+{
+    if (!counter)
+        return;
+
+    // 不是最后一个任务：直接减1
+    int pending = counter->m_Pending.load(std::memory_order_acquire);
+    while (pending > 1)
+    {
+        if (counter->m_Pending.compare_exchange_weak(pending, pending - 1, std::memory_order_acq_rel))
+            return;
+    }
+
+    // 最后一个任务：在锁内归零并取走等待列表
+    // Wait看到归零后会再获取一次这把锁，所以解锁之后这里不会再访问counter，等待方可以放心销毁它
+    std::vector<JobCounter::WaitingJob> waiting;
+    {
+        std::lock_guard<std::mutex> lock(counter->m_WaitingMutex);
+        if (counter->m_Pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            waiting.swap(counter->m_Waiting);
+    }
+    for (JobCounter::WaitingJob& job : waiting)
+    {
+        Job entry;
+        entry.function = std::move(job.function);
+        entry.counter = job.counter;
+        Push(std::move(entry));
+    }
+}
+
+void JobSystem::Wait(JobCounter& counter)
+{
+    unsigned int queueIndex = CurrentQueueIndex();
+    while (!counter.IsDone())
+    {
+        // 自己的队列空了就去偷；都没有任务时说明剩下的任务正在别的线程上执行
+        if (!TryRunOne(queueIndex))
+            std::this_thread::yield();
+    }
+
+    // 等完成方释放计数器的锁，之后调用方可以销毁counter
+    std::lock_guard<std::mutex> lock(counter.m_WaitingMutex);
+}
+
+void JobSystem::WorkerLoop(unsigned int queueIndex)
+{
+    t_QueueIndex = static_cast<int>(queueIndex);
+    char name[32];
+    std::snprintf(name, sizeof(name), "Worker %u", queueIndex);
+    GetProfiler().SetThreadName(name);
+    while (!m_Quit.load(std::memory_order_acquire))
+    {
+        if (TryRunOne(queueIndex))
+            continue;
+
+        // 先自旋一小会儿，短帧之间的任务间隔通常很短，睡眠再唤醒的延迟更高
+        bool found = false;
+        for (int spin = 0; spin < 64 && !found; ++spin)
+        {
+            if (m_QueuedCount.load(std::memory_order_acquire) > 0)
+                found = TryRunOne(queueIndex);
+            else
+                std::this_thread::yield();
+        }
+        if (found)
+            continue;
+
+        std::unique_lock<std::mutex> lock(m_SleepMutex);
+        m_SleepingCount.fetch_add(1);
+        m_WakeCondition.wait(lock, [this]() {
+            return m_Quit.load() || m_QueuedCount.load() > 0;
+        });
+        m_SleepingCount.fetch_sub(1);
+    }
+}
\ No newline at end of file
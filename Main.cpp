@@ -8,6 +8,7 @@ int main()
 
     TriangleApp app;
     app.SetMeshVerticals(mesh.GetVerticesFloat());
+    app.SetMeshIndices(mesh.GetIndices());
     app.Run();
     return 0;
 }
\ No newline at end of file
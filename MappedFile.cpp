@@ -0,0 +1,140 @@
+﻿#include "Core/MappedFile.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile()
+    : m_Data(nullptr), m_Size(0), m_IsOpen(false)
+#ifdef _WIN32
+    , m_FileHandle(nullptr), m_MappingHandle(nullptr)
+#else
+    , m_FileDescriptor(-1)
+#endif
+{
+}
+
+MappedFile::~MappedFile()
+{
+    Close();
+}
+
+#ifdef _WIN32
+
+bool MappedFile::Open(const std::string& filepath)
+{
+    Close();
+
+    HANDLE file = CreateFileA(filepath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize))
+    {
+        CloseHandle(file);
+        return false;
+    }
+
+    m_FileHandle = file;
+    m_Size = static_cast<size_t>(fileSize.QuadPart);
+    m_IsOpen = true;
+
+    // 空文件无法创建映射，直接返回空数据
+    if (m_Size == 0)
+        return true;
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping == nullptr)
+    {
+        Close();
+        return false;
+    }
+    m_MappingHandle = mapping;
+
+    m_Data = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    if (m_Data == nullptr)
+    {
+        Close();
+        return false;
+    }
+
+    return true;
+}
+
+void MappedFile::Close()
+{
+    if (m_Data)
+        UnmapViewOfFile(m_Data);
+    if (m_MappingHandle)
+        CloseHandle(static_cast<HANDLE>(m_MappingHandle));
+    if (m_FileHandle)
+        CloseHandle(static_cast<HANDLE>(m_FileHandle));
+
+    m_Data = nullptr;
+    m_Size = 0;
+    m_IsOpen = false;
+    m_MappingHandle = nullptr;
+    m_FileHandle = nullptr;
+}
+
+#else
+
+bool MappedFile::Open(const std::string& filepath)
+{
+    Close();
+
+    int fd = open(filepath.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0)
+    {
+        close(fd);
+        return false;
+    }
+
+    m_FileDescriptor = fd;
+    m_Size = static_cast<size_t>(st.st_size);
+    m_IsOpen = true;
+
+    // 空文件无法映射，直接返回空数据
+    if (m_Size == 0)
+        return true;
+
+    void* data = mmap(nullptr, m_Size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data == MAP_FAILED)
+    {
+        Close();
+        return false;
+    }
+
+    // 顺序扫描提示，让内核提前预读
+    madvise(data, m_Size, MADV_SEQUENTIAL);
+    m_Data = static_cast<const char*>(data);
+    return true;
+}
+
+void MappedFile::Close()
+{
+    if (m_Data)
+        munmap(const_cast<char*>(m_Data), m_Size);
+    if (m_FileDescriptor >= 0)
+        close(m_FileDescriptor);
+
+    m_Data = nullptr;
+    m_Size = 0;
+    m_IsOpen = false;
+    m_FileDescriptor = -1;
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,231 @@
+﻿#include "Math/Mat4.h"
+#include "Math/SimdUtils.h"
+#include "Math/MathKernels.h"
+
+Mat4::Mat4()
+{
+    for (int i = 0; i < 16; ++i)
+        m[i] = (i % 5 == 0) ? 1.0f : 0.0f;
+}
+
+Mat4::Mat4(const float columnMajor[16])
+{
+    for (int i = 0; i < 16; ++i)
+        m[i] = columnMajor[i];
+}
+
+#ifdef CENGINE_SIMD_SSE2
+
+// ============ SSE2实现 ============
+
+// 列向量线性组合：c0*v.x + c1*v.y + c2*v.z + c3*v.w
+static inline __m128 CombineColumns(const Mat4& mat, __m128 v)
+{
+    __m128 r = _mm_mul_ps(_mm_load_ps(&mat.m[0]), CE_SWIZZLE(v, 0, 0, 0, 0));
+    r = _mm_add_ps(r, _mm_mul_ps(_mm_load_ps(&mat.m[4]), CE_SWIZZLE(v, 1, 1, 1, 1)));
+    r = _mm_add_ps(r, _mm_mul_ps(_mm_load_ps(&mat.m[8]), CE_SWIZZLE(v, 2, 2, 2, 2)));
+    r = _mm_add_ps(r, _mm_mul_ps(_mm_load_ps(&mat.m[12]), CE_SWIZZLE(v, 3, 3, 3, 3)));
+    return r;
+}
+
+// 写出xyz三个分量，不越界写第4个float
+static inline void StoreVector3(Vector3& out, __m128 v)
+{
+    _mm_storel_pi(reinterpret_cast<__m64*>(&out.x), v);
+    _mm_store_ss(&out.z, _mm_movehl_ps(v, v));
+}
+
+Mat4 Mat4::operator*(const Mat4& rhs) const
+{
+    Mat4 result;
+#ifdef CENGINE_SIMD_AVX2
+    // 一次计算两列：低128位是第j列，高128位是第j+1列
+    __m256 c0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&m[0]));
+    __m256 c1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&m[4]));
+    __m256 c2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&m[8]));
+    __m256 c3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&m[12]));
+    for (int j = 0; j < 4; j += 2)
+    {
+        __m256 b = _mm256_load_ps(&rhs.m[j * 4]);
+        __m256 r = _mm256_mul_ps(c0, _mm256_permute_ps(b, CE_SHUFFLE_MASK(0, 0, 0, 0)));
+        r = _mm256_fmadd_ps(c1, _mm256_permute_ps(b, CE_SHUFFLE_MASK(1, 1, 1, 1)), r);
+        r = _mm256_fmadd_ps(c2, _mm256_permute_ps(b, CE_SHUFFLE_MASK(2, 2, 2, 2)), r);
+        r = _mm256_fmadd_ps(c3, _mm256_permute_ps(b, CE_SHUFFLE_MASK(3, 3, 3, 3)), r);
+        _mm256_store_ps(&result.m[j * 4], r);
+    }
+#else
+    for (int j = 0; j < 4; ++j)
+        _mm_store_ps(&result.m[j * 4], CombineColumns(*this, _mm_load_ps(&rhs.m[j * 4])));
+#endif
+    return result;
+}
+
+// 2x2矩阵按(a, b, c, d)打包在一个寄存器里
+// A * B
+static inline __m128 Mat2Mul(__m128 a, __m128 b)
+{
+    return _mm_add_ps(_mm_mul_ps(a, CE_SWIZZLE(b, 0, 3, 0, 3)),
+        _mm_mul_ps(CE_SWIZZLE(a, 1, 0, 3, 2), CE_SWIZZLE(b, 2, 1, 2, 1)));
+}
+
+// adj(A) * B
+static inline __m128 Mat2AdjMul(__m128 a, __m128 b)
+{
+    return _mm_sub_ps(_mm_mul_ps(CE_SWIZZLE(a, 3, 3, 0, 0), b),
+        _mm_mul_ps(CE_SWIZZLE(a, 1, 1, 2, 2), CE_SWIZZLE(b, 2, 3, 0, 1)));
+}
+
+// A * adj(B)
+static inline __m128 Mat2MulAdj(__m128 a, __m128 b)
+{
+    return _mm_sub_ps(_mm_mul_ps(a, CE_SWIZZLE(b, 3, 0, 3, 0)),
+        _mm_mul_ps(CE_SWIZZLE(a, 1, 0, 3, 2), CE_SWIZZLE(b, 2, 1, 2, 1)));
+}
+
+Mat4 Mat4::Inverse() const
+{
+    // 分块矩阵求逆：M = | A B |，四个2x2子块
+    //                   | C D |
+    // 算法对行主序推导，(M^T)^-1 = (M^-1)^T，因此直接作用于列主序数据同样成立
+    __m128 r0 = _mm_load_ps(&m[0]);
+    __m128 r1 = _mm_load_ps(&m[4]);
+    __m128 r2 = _mm_load_ps(&m[8]);
+    __m128 r3 = _mm_load_ps(&m[12]);
+
+    __m128 A = _mm_movelh_ps(r0, r1);
+    __m128 B = _mm_movehl_ps(r1, r0);
+    __m128 C = _mm_movelh_ps(r2, r3);
+    __m128 D = _mm_movehl_ps(r3, r2);
+
+    // (|A|, |B|, |C|, |D|)
+    __m128 detSub = _mm_sub_ps(
+        _mm_mul_ps(CE_SHUFFLE(r0, r2, 0, 2, 0, 2), CE_SHUFFLE(r1, r3, 1, 3, 1, 3)),
+        _mm_mul_ps(CE_SHUFFLE(r0, r2, 1, 3, 1, 3), CE_SHUFFLE(r1, r3, 0, 2, 0, 2)));
+    __m128 detA = CE_SWIZZLE(detSub, 0, 0, 0, 0);
+    __m128 detB = CE_SWIZZLE(detSub, 1, 1, 1, 1);
+    __m128 detC = CE_SWIZZLE(detSub, 2, 2, 2, 2);
+    __m128 detD = CE_SWIZZLE(detSub, 3, 3, 3, 3);
+
+    __m128 D_C = Mat2AdjMul(D, C);
+    __m128 A_B = Mat2AdjMul(A, B);
+
+    // M^-1 = 1/|M| * | X Y |，这里先求各块的伴随
+    //                | Z W |
+    __m128 X_ = _mm_sub_ps(_mm_mul_ps(detD, A), Mat2Mul(B, D_C));
+    __m128 W_ = _mm_sub_ps(_mm_mul_ps(detA, D), Mat2Mul(C, A_B));
+    __m128 Y_ = _mm_sub_ps(_mm_mul_ps(detB, C), Mat2MulAdj(D, A_B));
+    __m128 Z_ = _mm_sub_ps(_mm_mul_ps(detC, B), Mat2MulAdj(A, D_C));
+
+    // |M| = |A||D| + |B||C| - tr(adj(A)B adj(D)C)
+    __m128 detM = _mm_add_ps(_mm_mul_ps(detA, detD), _mm_mul_ps(detB, detC));
+    __m128 tr = _mm_mul_ps(A_B, CE_SWIZZLE(D_C, 0, 2, 1, 3));
+    tr = _mm_add_ps(tr, CE_SWIZZLE(tr, 1, 0, 3, 2));
+    tr = _mm_add_ps(tr, CE_SWIZZLE(tr, 2, 3, 0, 1));
+    detM = _mm_sub_ps(detM, tr);
+
+    __m128 rDetM = _mm_div_ps(_mm_setr_ps(1.0f, -1.0f, -1.0f, 1.0f), detM);
+    X_ = _mm_mul_ps(X_, rDetM);
+    Y_ = _mm_mul_ps(Y_, rDetM);
+    Z_ = _mm_mul_ps(Z_, rDetM);
+    W_ = _mm_mul_ps(W_, rDetM);
+
+    // 伴随的重排与写回合并成一次shuffle
+    Mat4 result;
+    _mm_store_ps(&result.m[0], CE_SHUFFLE(X_, Y_, 3, 1, 3, 1));
+    _mm_store_ps(&result.m[4], CE_SHUFFLE(X_, Y_, 2, 0, 2, 0));
+    _mm_store_ps(&result.m[8], CE_SHUFFLE(Z_, W_, 3, 1, 3, 1));
+    _mm_store_ps(&result.m[12], CE_SHUFFLE(Z_, W_, 2, 0, 2, 0));
+    return result;
+}
+
+Vec4 Mat4::Transform(const Vec4& v) const
+{
+    return Vec4::FromSimd(CombineColumns(*this, v.Load()));
+}
+
+Vector3 Mat4::TransformPoint(const Vector3& p) const
+{
+    Vector3 result;
+    StoreVector3(result, CombineColumns(*this, _mm_setr_ps(p.x, p.y, p.z, 1.0f)));
+    return result;
+}
+
+Vector3 Mat4::TransformDirection(const Vector3& d) const
+{
+    Vector3 result;
+    StoreVector3(result, CombineColumns(*this, _mm_setr_ps(d.x, d.y, d.z, 0.0f)));
+    return result;
+}
+
+#else
+
+// ============ 标量实现（无SSE2的平台） ============
+
+Mat4 Mat4::operator*(const Mat4& rhs) const
+{
+    Mat4 result;
+    for (int j = 0; j < 4; ++j)
+        for (int i = 0; i < 4; ++i)
+            result.m[j * 4 + i] = m[i] * rhs.m[j * 4] + m[4 + i] * rhs.m[j * 4 + 1]
+                + m[8 + i] * rhs.m[j * 4 + 2] + m[12 + i] * rhs.m[j * 4 + 3];
+    return result;
+}
+
+Mat4 Mat4::Inverse() const
+{
+    // 余子式展开
+    float inv[16];
+    inv[0] = m[5] * m[10] * m[15] - m[5] * m[11] * m[14] - m[9] * m[6] * m[15] + m[9] * m[7] * m[14] + m[13] * m[6] * m[11] - m[13] * m[7] * m[10];
+    inv[4] = -m[4] * m[10] * m[15] + m[4] * m[11] * m[14] + m[8] * m[6] * m[15] - m[8] * m[7] * m[14] - m[12] * m[6] * m[11] + m[12] * m[7] * m[10];
+    inv[8] = m[4] * m[9] * m[15] - m[4] * m[11] * m[13] - m[8] * m[5] * m[15] + m[8] * m[7] * m[13] + m[12] * m[5] * m[11] - m[12] * m[7] * m[9];
+    inv[12] = -m[4] * m[9] * m[14] + m[4] * m[10] * m[13] + m[8] * m[5] * m[14] - m[8] * m[6] * m[13] - m[12] * m[5] * m[10] + m[12] * m[6] * m[9];
+    inv[1] = -m[1] * m[10] * m[15] + m[1] * m[11] * m[14] + m[9] * m[2] * m[15] - m[9] * m[3] * m[14] - m[13] * m[2] * m[11] + m[13] * m[3] * m[10];
+    inv[5] = m[0] * m[10] * m[15] - m[0] * m[11] * m[14] - m[8] * m[2] * m[15] + m[8] * m[3] * m[14] + m[12] * m[2] * m[11] - m[12] * m[3] * m[10];
+    inv[9] = -m[0] * m[9] * m[15] + m[0] * m[11] * m[13] + m[8] * m[1] * m[15] - m[8] * m[3] * m[13] - m[12] * m[1] * m[11] + m[12] * m[3] * m[9];
+    inv[13] = m[0] * m[9] * m[14] - m[0] * m[10] * m[13] - m[8] * m[1] * m[14] + m[8] * m[2] * m[13] + m[12] * m[1] * m[10] - m[12] * m[2] * m[9];
+    inv[2] = m[1] * m[6] * m[15] - m[1] * m[7] * m[14] - m[5] * m[2] * m[15] + m[5] * m[3] * m[14] + m[13] * m[2] * m[7] - m[13] * m[3] * m[6];
+    inv[6] = -m[0] * m[6] * m[15] + m[0] * m[7] * m[14] + m[4] * m[2] * m[15] - m[4] * m[3] * m[14] - m[12] * m[2] * m[7] + m[12] * m[3] * m[6];
+    inv[10] = m[0] * m[5] * m[15] - m[0] * m[7] * m[13] - m[4] * m[1] * m[15] + m[4] * m[3] * m[13] + m[12] * m[1] * m[7] - m[12] * m[3] * m[5];
+    inv[14] = -m[0] * m[5] * m[14] + m[0] * m[6] * m[13] + m[4] * m[1] * m[14] - m[4] * m[2] * m[13] - m[12] * m[1] * m[6] + m[12] * m[2] * m[5];
+    inv[3] = -m[1] * m[6] * m[11] + m[1] * m[7] * m[10] + m[5] * m[2] * m[11] - m[5] * m[3] * m[10] - m[9] * m[2] * m[7] + m[9] * m[3] * m[6];
+    inv[7] = m[0] * m[6] * m[11] - m[0] * m[7] * m[10] - m[4] * m[2] * m[11] + m[4] * m[3] * m[10] + m[8] * m[2] * m[7] - m[8] * m[3] * m[6];
+    inv[11] = -m[0] * m[5] * m[11] + m[0] * m[7] * m[9] + m[4] * m[1] * m[11] - m[4] * m[3] * m[9] - m[8] * m[1] * m[7] + m[8] * m[3] * m[5];
+    inv[15] = m[0] * m[5] * m[10] - m[0] * m[6] * m[9] - m[4] * m[1] * m[10] + m[4] * m[2] * m[9] + m[8] * m[1] * m[6] - m[8] * m[2] * m[5];
+
+    float invDet = 1.0f / (m[0] * inv[0] + m[1] * inv[4] + m[2] * inv[8] + m[3] * inv[12]);
+    Mat4 result;
+    for (int i = 0; i < 16; ++i)
+        result.m[i] = inv[i] * invDet;
+    return result;
+}
+
+Vec4 Mat4::Transform(const Vec4& v) const
+{
+    return Vec4(
+        m[0] * v.x + m[4] * v.y + m[8] * v.z + m[12] * v.w,
+        m[1] * v.x + m[5] * v.y + m[9] * v.z + m[13] * v.w,
+        m[2] * v.x + m[6] * v.y + m[10] * v.z + m[14] * v.w,
+        m[3] * v.x + m[7] * v.y + m[11] * v.z + m[15] * v.w);
+}
+
+Vector3 Mat4::TransformPoint(const Vector3& p) const
+{
+    return Transform(Vec4(p, 1.0f)).ToVector3();
+}
+
+Vector3 Mat4::TransformDirection(const Vector3& d) const
+{
+    return Transform(Vec4(d, 0.0f)).ToVector3();
+}
+
+#endif
+
+void Mat4::TransformPoints(const Vector3* in, Vector3* out, size_t count) const
+{
+    GetMathKernels().transformVector3(m, in, out, count, 1.0f);
+}
+
+void Mat4::TransformDirections(const Vector3* in, Vector3* out, size_t count) const
+{
+    GetMathKernels().transformVector3(m, in, out, count, 0.0f);
+}
\ No newline at end of file
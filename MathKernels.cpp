@@ -0,0 +1,46 @@
+﻿#include "Math/MathKernels.h"
+#include "Math/ScalarKernels.h"
+
+// ============ 标量档位 ============
+
+static void TransformVector3Kernel(const float* matrix, const Vector3* in, Vector3* out, size_t count, float w)
+{
+    TransformVector3Scalar(matrix, in, out, 0, count, w);
+}
+
+static size_t CullBackFaces16Kernel(const Vector3* vertices, const uint32_t* indices, size_t triangleCount, uint16_t* output)
+{
+    return CullRangeScalar(vertices, indices, 0, triangleCount, output, 0);
+}
+
+static size_t CullBackFaces32Kernel(const Vector3* vertices, const uint32_t* indices, size_t triangleCount, uint32_t* output)
+{
+    return CullRangeScalar(vertices, indices, 0, triangleCount, output, 0);
+}
+
+const MathKernels* GetScalarMathKernels()
+{
+    static const MathKernels kernels = {
+        SimdLevel::Scalar,
+        TransformVector3Kernel,
+        CullBackFaces16Kernel,
+        CullBackFaces32Kernel,
+    };
+    return &kernels;
+}
+
+// ============ 分派 ============
+
+const MathKernels& GetMathKernels()
+{
+    // 按档位从高到低找第一张编译进来的表
+    SimdLevel level = GetActiveSimdLevel();
+    const MathKernels* kernels = nullptr;
+    if (level >= SimdLevel::AVX2 && !kernels)
+        kernels = GetAvx2MathKernels();
+    if (level >= SimdLevel::SSE2 && !kernels)
+        kernels = GetSse2MathKernels();
+    if (!kernels)
+        kernels = GetScalarMathKernels();
+    return *kernels;
+}
\ No newline at end of file
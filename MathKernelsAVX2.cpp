@@ -0,0 +1,145 @@
+﻿#include "Math/MathKernels.h"
+#include "Math/ScalarKernels.h"
+#include "Math/SimdUtils.h"
+
+// ============ AVX2档位 ============
+// 这个文件单独用AVX2编译：MSVC为 /arch:AVX2（见工程文件中该文件的设置），GCC/Clang为 -mavx2 -mfma -ffp-contract=off
+// （GCC默认会把乘加自动合并成FMA，剔除的判断结果就会和标量档位不同）
+// 只有CPU支持AVX2和FMA时才会被GetMathKernels选中，其余文件保持基本指令集
+// 不要在这里包含带inline函数的头文件（如Math/Mat4.h、Math/Vec4.h），
+// 链接器可能保留这里生成的AVX2版本给全程序使用
+
+#ifdef CENGINE_SIMD_AVX2
+
+// 每次8个点，矩阵元素各广播到一个寄存器
+// 不用FMA：乘和加分开舍入，求和顺序与TransformVector3Scalar相同，各档位的结果逐位一致
+static void TransformVector3Kernel(const float* m, const Vector3* in, Vector3* out, size_t count, float w)
+{
+    __m256 m0 = _mm256_set1_ps(m[0]), m1 = _mm256_set1_ps(m[1]), m2 = _mm256_set1_ps(m[2]);
+    __m256 m4 = _mm256_set1_ps(m[4]), m5 = _mm256_set1_ps(m[5]), m6 = _mm256_set1_ps(m[6]);
+    __m256 m8 = _mm256_set1_ps(m[8]), m9 = _mm256_set1_ps(m[9]), m10 = _mm256_set1_ps(m[10]);
+    __m256 t0 = _mm256_set1_ps(m[12] * w), t1 = _mm256_set1_ps(m[13] * w), t2 = _mm256_set1_ps(m[14] * w);
+
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256 x, y, z;
+        LoadSoA8(&in[i].x, x, y, z);
+        __m256 nx = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(m0, x), _mm256_mul_ps(m4, y)), _mm256_mul_ps(m8, z)), t0);
+        __m256 ny = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(m1, x), _mm256_mul_ps(m5, y)), _mm256_mul_ps(m9, z)), t1);
+        __m256 nz = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(m2, x), _mm256_mul_ps(m6, y)), _mm256_mul_ps(m10, z)), t2);
+        StoreSoA8(&out[i].x, nx, ny, nz);
+    }
+
+    TransformVector3Scalar(m, in, out, i, count, w);
+}
+
+// x和y相邻，作为一个64位元素gather，gather次数减半
+// 结果的通道顺序为 0 1 4 5 2 3 6 7，由调用方还原
+static inline void GatherXY(const float* base, __m256i offsets, __m256& x, __m256& y)
+{
+    const long long* pairs = reinterpret_cast<const long long*>(base);
+    __m256 lo = _mm256_castsi256_ps(_mm256_i32gather_epi64(pairs, _mm256_castsi256_si128(offsets), 4));
+    __m256 hi = _mm256_castsi256_ps(_mm256_i32gather_epi64(pairs, _mm256_extracti128_si256(offsets, 1), 4));
+    x = _mm256_shuffle_ps(lo, hi, CE_SHUFFLE_MASK(0, 2, 0, 2));
+    y = _mm256_shuffle_ps(lo, hi, CE_SHUFFLE_MASK(1, 3, 1, 3));
+}
+
+// 原样复制8个三角形的24个索引
+static inline void CopyIndices(const uint32_t* triangles, uint32_t* output)
+{
+    for (int i = 0; i < 24; i += 8)
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(output + i), _mm256_loadu_si256(reinterpret_cast<const __m256i*>(triangles + i)));
+}
+
+static inline void CopyIndices(const uint32_t* triangles, uint16_t* output)
+{
+    // 16位索引网格的顶点数不超过65536，packus不会饱和
+    for (int i = 0; i < 24; i += 8)
+    {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(triangles + i));
+        __m128i packed = _mm_packus_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output + i), packed);
+    }
+}
+
+// 每次8个三角形：索引转成x/y/z三组通道，按索引gather出顶点的x和y
+// z分量与背面判断无关，不读取
+template<typename IndexType>
+static size_t CullBackFacesAvx2(const Vector3* vertices, const uint32_t* indices, size_t triangleCount, IndexType* output)
+{
+    size_t count = 0;
+    size_t t = 0;
+    const float* base = &vertices[0].x;
+    const __m256 zero = _mm256_setzero_ps();
+    for (; t + 8 <= triangleCount; t += 8)
+    {
+        const uint32_t* triangles = indices + t * 3;
+        __m256 ia, ib, ic;
+        LoadSoA8(reinterpret_cast<const float*>(triangles), ia, ib, ic);
+
+        // 顶点下标换算成float偏移：index * 3
+        __m256i oa = _mm256_castps_si256(ia);
+        __m256i ob = _mm256_castps_si256(ib);
+        __m256i oc = _mm256_castps_si256(ic);
+        oa = _mm256_add_epi32(_mm256_slli_epi32(oa, 1), oa);
+        ob = _mm256_add_epi32(_mm256_slli_epi32(ob, 1), ob);
+        oc = _mm256_add_epi32(_mm256_slli_epi32(oc, 1), oc);
+
+        __m256 ax, ay, bx, by, cx, cy;
+        GatherXY(base, oa, ax, ay);
+        GatherXY(base, ob, bx, by);
+        GatherXY(base, oc, cx, cy);
+
+        // 不用FMA：与标量档位的判断结果保持一致，切换档位时可见三角形不变
+        __m256 crossZ = _mm256_sub_ps(_mm256_mul_ps(_mm256_sub_ps(bx, ax), _mm256_sub_ps(cy, ay)),
+            _mm256_mul_ps(_mm256_sub_ps(by, ay), _mm256_sub_ps(cx, ax)));
+        uint32_t mask = static_cast<uint32_t>(_mm256_movemask_ps(_mm256_cmp_ps(crossZ, zero, _CMP_LT_OQ)));
+        mask = (mask & 0xC3) | ((mask & 0x0C) << 2) | ((mask & 0x30) >> 2);
+
+        // 相邻三角形的朝向通常一致，整组可见或整组不可见时走快速路径
+        if (mask == 0xFF)
+        {
+            CopyIndices(triangles, output + count);
+            count += 24;
+        }
+        else if (mask != 0)
+        {
+            for (int k = 0; k < 8; ++k)
+                count = EmitTriangle(triangles + k * 3, output, count, (mask >> k) & 1u);
+        }
+    }
+
+    return CullRangeScalar(vertices, indices, t, triangleCount, output, count);
+}
+
+static size_t CullBackFaces16Kernel(const Vector3* vertices, const uint32_t* indices, size_t triangleCount, uint16_t* output)
+{
+    return CullBackFacesAvx2(vertices, indices, triangleCount, output);
+}
+
+static size_t CullBackFaces32Kernel(const Vector3* vertices, const uint32_t* indices, size_t triangleCount, uint32_t* output)
+{
+    return CullBackFacesAvx2(vertices, indices, triangleCount, output);
+}
+
+const MathKernels* GetAvx2MathKernels()
+{
+    static const MathKernels kernels = {
+        SimdLevel::AVX2,
+        TransformVector3Kernel,
+        CullBackFaces16Kernel,
+        CullBackFaces32Kernel,
+    };
+    return &kernels;
+}
+
+#else
+
+// 没有用AVX2选项编译这个文件时不提供AVX2档位，分派会退回SSE2
+const MathKernels* GetAvx2MathKernels()
+{
+    return nullptr;
+}
+
+#endif
\ No newline at end of file
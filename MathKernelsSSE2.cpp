@@ -0,0 +1,62 @@
+﻿#include "Math/MathKernels.h"
+#include "Math/ScalarKernels.h"
+#include "Math/SimdUtils.h"
+
+// ============ SSE2档位 ============
+// x64上SSE2是基本指令集，这个文件不需要额外的编译选项
+
+#ifdef CENGINE_SIMD_SSE2
+
+// 每次4个点：转成x/y/z各4通道，矩阵元素各广播到一个寄存器
+// 求和顺序与TransformVector3Scalar相同，各档位的结果逐位一致
+static void TransformVector3Kernel(const float* m, const Vector3* in, Vector3* out, size_t count, float w)
+{
+    __m128 s0 = _mm_set1_ps(m[0]), s1 = _mm_set1_ps(m[1]), s2 = _mm_set1_ps(m[2]);
+    __m128 s4 = _mm_set1_ps(m[4]), s5 = _mm_set1_ps(m[5]), s6 = _mm_set1_ps(m[6]);
+    __m128 s8 = _mm_set1_ps(m[8]), s9 = _mm_set1_ps(m[9]), s10 = _mm_set1_ps(m[10]);
+    __m128 u0 = _mm_set1_ps(m[12] * w), u1 = _mm_set1_ps(m[13] * w), u2 = _mm_set1_ps(m[14] * w);
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 x, y, z;
+        LoadSoA4(&in[i].x, x, y, z);
+        __m128 nx = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(s0, x), _mm_mul_ps(s4, y)), _mm_mul_ps(s8, z)), u0);
+        __m128 ny = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(s1, x), _mm_mul_ps(s5, y)), _mm_mul_ps(s9, z)), u1);
+        __m128 nz = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(s2, x), _mm_mul_ps(s6, y)), _mm_mul_ps(s10, z)), u2);
+        StoreSoA4(&out[i].x, nx, ny, nz);
+    }
+
+    TransformVector3Scalar(m, in, out, i, count, w);
+}
+
+// SSE2没有gather，逐个读顶点和向量化的收益抵消，剔除直接用标量循环
+static size_t CullBackFaces16Kernel(const Vector3* vertices, const uint32_t* indices, size_t triangleCount, uint16_t* output)
+{
+    return CullRangeScalar(vertices, indices, 0, triangleCount, output, 0);
+}
+
+static size_t CullBackFaces32Kernel(const Vector3* vertices, const uint32_t* indices, size_t triangleCount, uint32_t* output)
+{
+    return CullRangeScalar(vertices, indices, 0, triangleCount, output, 0);
+}
+
+const MathKernels* GetSse2MathKernels()
+{
+    static const MathKernels kernels = {
+        SimdLevel::SSE2,
+        TransformVector3Kernel,
+        CullBackFaces16Kernel,
+        CullBackFaces32Kernel,
+    };
+    return &kernels;
+}
+
+#else
+
+const MathKernels* GetSse2MathKernels()
+{
+    return nullptr;
+}
+
+#endif
\ No newline at end of file
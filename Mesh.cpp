@@ -1,116 +1,647 @@
 #include "Mesh.h"
-#include <fstream>
-#include <sstream>
+#include "CookedMesh.h"
+#include "Triangulation.h"
+#include "Core/Profiler.h"
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <climits>
+#include <cstdint>
+#include <cstring>
 #include <iostream>
+#include <thread>
+
+// ============ ޷Ĵʷ ============
+
+static inline bool IsBlank(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+static inline const char* SkipBlanks(const char* p, const char* end)
+{
+    while (p < end && IsBlank(*p)) ++p;
+    return p;
+}
+
+static inline const char* SkipToken(const char* p, const char* end)
+{
+    while (p < end && !IsBlank(*p)) ++p;
+    return p;
+}
+
+// һʧܷnullptrstd::from_charslocaleӰ죬Ҳڴ棩
+static const char* ParseFloat(const char* p, const char* end, float& value)
+{
+    p = SkipBlanks(p, end);
+    if (p < end && *p == '+') ++p;  // from_chars
+
+    std::from_chars_result result = std::from_chars(p, end, value);
+    if (result.ec != std::errc())
+        return nullptr;
+    return result.ptr;
+}
+
+// һѡֶΣֶλ޷ʱΪ0ʾȱʧ
+static const char* ParseOptionalIndex(const char* p, const char* end, int& value)
+{
+    value = 0;
+    if (p < end && *p == '+') ++p;
+    std::from_chars_result result = std::from_chars(p, end, value);
+    if (result.ec != std::errc()) {
+        value = 0;
+    }
+
+    // һб
+    while (p < end && *p != '/') ++p;
+    return p;
+}
+
+// token "v""v/vt""v//vn""v/vt/vn"OBJԭʼֵ1ʼʧܷfalse
+static bool ParseFaceCorner(const char* begin, const char* end, ObjCorner& corner)
+{
+    // Чfrom_charsбȻֹͣ
+    const char* digits = (begin < end && *begin == '+') ? begin + 1 : begin;
+
+    std::from_chars_result result = std::from_chars(digits, end, corner.position);
+    if (result.ec != std::errc() || (result.ptr != end && *result.ptr != '/')) {
+        return false;
+    }
+
+    // ͷֻ붥ȥ
+    const char* p = result.ptr;
+    corner.texcoord = 0;
+    corner.normal = 0;
+    if (p < end) p = ParseOptionalIndex(p + 1, end, corner.texcoord);
+    if (p < end) p = ParseOptionalIndex(p + 1, end, corner.normal);
+
+    // INT_MIN·Ϊʧܱ
+    return corner.position != INT_MIN;
+}
+
+// еһtokenֱָӳڴ
+struct FaceToken
+{
+    const char* begin;
+    const char* end;
+};
+
+// зУtokensиã
+static void TokenizeFace(const char* p, const char* lineEnd, std::vector<FaceToken>& tokens)
+{
+    tokens.clear();
+    const char* token = SkipBlanks(p, lineEnd);
+    while (token < lineEnd) {
+        const char* next = SkipToken(token, lineEnd);
+        tokens.push_back(FaceToken{ token, next });
+        token = SkipBlanks(next, lineEnd);
+    }
+}
+
+// ǻһ棨ǵ㶥Ѵ0ʼνǵ׷ӵoutput
+static void TriangulateFace(const ObjCorner* face, size_t count, const std::vector<Vector3>& positions,
+    std::vector<Vector3>& facePoints, TriangulationScratch& scratch, std::vector<ObjCorner>& output)
+{
+    if (count == 3) {
+        output.insert(output.end(), face, face + 3);
+        return;
+    }
+
+    facePoints.clear();
+    for (size_t i = 0; i < count; ++i) {
+        facePoints.push_back(positions[face[i].position]);
+    }
+
+    TriangulatePolygon(facePoints.data(), count, scratch);
+    for (uint32_t local : scratch.triangles) {
+        output.push_back(face[local]);
+    }
+}
+
+// ============ м ============
+
+// СڸôСļߴ·ֵ߳
+static const size_t ParallelLoadMinBytes = 4 * 1024 * 1024;
+
+// threadCount߳ȡ[0, count)
+template<typename Func>
+static void ParallelFor(size_t count, unsigned int threadCount, const Func& func)
+{
+    std::atomic<size_t> next(0);
+    auto worker = [&]() {
+        for (size_t i = next.fetch_add(1); i < count; i = next.fetch_add(1)) {
+            func(i);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (unsigned int t = 1; t < threadCount; ++t) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+}
+
+// һзֵļ鼰ֲ
+struct ObjChunk
+{
+    const char* begin = nullptr;
+    const char* end = nullptr;
+
+    std::vector<Vector3> positions;       // ڵĶλ
+    std::vector<ObjCorner> corners;       // νǵOBJԭʼpositionΪINT_MINʾʧ
+    std::vector<uint32_t> faceSizes;      // ÿĽǵ
+    std::vector<std::string> failedTokens; // ʧܵtoken˳
+    // (ǵ±, ѳֶ)ǵֻ֮ǰֵĶ
+    std::vector<std::pair<size_t, size_t>> positionLimits;
+
+    size_t positionOffset = 0;  // ǰпĶǰ׺ͣ
+    std::vector<ObjCorner> triangles;     // ǻĽǵ㣬0ʼ
+    size_t outputOffset = 0;    // ǰпνǵǰ׺ͣ
+    bool hasErrors = false;
+};
+
+// һvf¼ֻд鱾
+static void ParseObjChunk(ObjChunk& chunk)
+{
+    PROFILE_ZONE("ParseObjChunk");
+    std::vector<FaceToken> tokens;
+    const char* p = chunk.begin;
+    const char* end = chunk.end;
+    while (p < end) {
+        const char* lineEnd = static_cast<const char*>(std::memchr(p, '\n', end - p));
+        if (lineEnd == nullptr) {
+            lineEnd = end;
+        }
+
+        const char* cur = SkipBlanks(p, lineEnd);
+        p = lineEnd + 1;
+
+        if (cur == lineEnd || *cur == '#') {
+            continue;
+        }
+
+        const char* prefixEnd = SkipToken(cur, lineEnd);
+        size_t prefixLength = prefixEnd - cur;
+
+        if (prefixLength == 1 && *cur == 'v') {
+            float x, y, z;
+            const char* next = ParseFloat(prefixEnd, lineEnd, x);
+            if (next) next = ParseFloat(next, lineEnd, y);
+            if (next) next = ParseFloat(next, lineEnd, z);
+            if (next) {
+                chunk.positions.push_back(Vector3(x, y, z));
+            }
+        }
+        else if (prefixLength == 1 && *cur == 'f') {
+            TokenizeFace(prefixEnd, lineEnd, tokens);
+            if (tokens.size() < 3) {
+                continue;
+            }
+
+            if (chunk.positionLimits.empty() || chunk.positionLimits.back().second != chunk.positions.size()) {
+                chunk.positionLimits.push_back(std::make_pair(chunk.corners.size(), chunk.positions.size()));
+            }
+
+            // ǻҪȫֶŵϲ׶ν
+            for (const FaceToken& token : tokens) {
+                ObjCorner corner;
+                if (!ParseFaceCorner(token.begin, token.end, corner)) {
+                    corner.position = INT_MIN;
+                    chunk.failedTokens.push_back(std::string(token.begin, token.end));
+                }
+                chunk.corners.push_back(corner);
+            }
+            chunk.faceSizes.push_back(static_cast<uint32_t>(tokens.size()));
+        }
+    }
+}
+
+// ˳ѯڽǵõȫֶ
+class PositionLimitCursor
+{
+public:
+    explicit PositionLimitCursor(const ObjChunk& chunk)
+        : _chunk(chunk), _next(0), _limit(chunk.positionOffset)
+    {
+    }
+
+    // corner뵥
+    size_t At(size_t corner)
+    {
+        while (_next < _chunk.positionLimits.size() && _chunk.positionLimits[_next].first <= corner) {
+            _limit = _chunk.positionOffset + _chunk.positionLimits[_next].second;
+            ++_next;
+        }
+        return _limit;
+    }
+
+private:
+    const ObjChunk& _chunk;
+    size_t _next;
+    size_t _limit;
+};
+
+static inline bool IsValidCorner(int value, size_t limit)
+{
+    return value != INT_MIN && value >= 1 && static_cast<size_t>(value) - 1 < limit;
+}
+
+// ============ ȥ ============
+
+static inline bool SameCorner(const ObjCorner& a, const ObjCorner& b)
+{
+    return a.position == b.position && a.texcoord == b.texcoord && a.normal == b.normal;
+}
+
 
 Mesh::Mesh()
+    : _loadThreadCount(0), _useCookedCache(true), _cookedHeader(nullptr)
+{
+}
+
+void Mesh::SetLoadThreadCount(unsigned int threadCount)
+{
+    _loadThreadCount = threadCount;
+}
+
+void Mesh::SetUseCookedCache(bool useCookedCache)
+{
+    _useCookedCache = useCookedCache;
+}
+
+const Vector3* Mesh::GetVertexData() const
+{
+    if (_cookedHeader) {
+        return reinterpret_cast<const Vector3*>(_cookedFile.GetData() + _cookedHeader->vertexOffset);
+    }
+    return _verticeArray.data();
+}
+
+size_t Mesh::GetVertexCount() const
+{
+    return _cookedHeader ? static_cast<size_t>(_cookedHeader->vertexCount) : _verticeArray.size();
+}
+
+const uint32_t* Mesh::GetIndexData() const
+{
+    if (_cookedHeader) {
+        return reinterpret_cast<const uint32_t*>(_cookedFile.GetData() + _cookedHeader->indexOffset);
+    }
+    return _indexArray.data();
+}
+
+size_t Mesh::GetIndexCount() const
+{
+    return _cookedHeader ? static_cast<size_t>(_cookedHeader->indexCount) : _indexArray.size();
+}
+
+std::vector<Vector3> Mesh::GetVertices() const
+{
+    return std::vector<Vector3>(GetVertexData(), GetVertexData() + GetVertexCount());
+}
+
+std::vector<uint32_t> Mesh::GetIndices() const
 {
+    return std::vector<uint32_t>(GetIndexData(), GetIndexData() + GetIndexCount());
 }
-std::vector<float> Mesh::GetVerticesFloat() {
+
+std::vector<float> Mesh::GetVerticesFloat() const {
+    const Vector3* vertices = GetVertexData();
+    size_t vertexCount = GetVertexCount();
+
     std::vector<float> result;
-    for (size_t i = 0; i < _verticeArray.size(); i++)
+    result.reserve(vertexCount * 3);
+    for (size_t i = 0; i < vertexCount; i++)
     {
-        result.push_back(_verticeArray[i].x);
-        result.push_back(_verticeArray[i].y);
-        result.push_back(_verticeArray[i].z);
+        result.push_back(vertices[i].x);
+        result.push_back(vertices[i].y);
+        result.push_back(vertices[i].z);
     }
     return result;
 }
 
+bool Mesh::LoadCookedMesh(const std::string& cookedPath, const CookedMeshSourceStamp& source)
+{
+    PROFILE_ZONE("Mesh::LoadCookedMesh");
+    if (!_cookedFile.Open(cookedPath)) {
+        return false;
+    }
+
+    _cookedHeader = ValidateCookedMesh(_cookedFile.GetData(), _cookedFile.GetSize());
+    if (_cookedHeader == nullptr) {
+        std::cerr << "棺ļЧ½: " << cookedPath << std::endl;
+        _cookedFile.Close();
+        return false;
+    }
+    if (!IsCookedMeshFresh(*_cookedHeader, source)) {
+        _cookedHeader = nullptr;
+        _cookedFile.Close();
+        return false;
+    }
+
+    _boundsMin = Vector3(_cookedHeader->boundsMin[0], _cookedHeader->boundsMin[1], _cookedHeader->boundsMin[2]);
+    _boundsMax = Vector3(_cookedHeader->boundsMax[0], _cookedHeader->boundsMax[1], _cookedHeader->boundsMax[2]);
+    return true;
+}
+
+void Mesh::ComputeBounds()
+{
+    if (_verticeArray.empty()) {
+        _boundsMin = Vector3();
+        _boundsMax = Vector3();
+        return;
+    }
+
+    _boundsMin = _verticeArray[0];
+    _boundsMax = _verticeArray[0];
+    for (const Vector3& v : _verticeArray) {
+        _boundsMin = Vector3(std::min(_boundsMin.x, v.x), std::min(_boundsMin.y, v.y), std::min(_boundsMin.z, v.z));
+        _boundsMax = Vector3(std::max(_boundsMax.x, v.x), std::max(_boundsMax.y, v.y), std::max(_boundsMax.z, v.z));
+    }
+}
+
 void Mesh::LoadMeshFromPath(const std::string& filepath)
 {
+    PROFILE_ZONE("Mesh::LoadMeshFromPath");
     _verticeArray.clear();
-    // ļ
-    std::ifstream file(filepath);
-    if (!file.is_open()) {
+    _indexArray.clear();
+    _cookedHeader = nullptr;
+    _cookedFile.Close();
+
+    // ¼ԴļС޸ʱ뵱ǰһʱֱӳ仺棬
+    std::string cookedPath = GetCookedMeshPath(filepath);
+    CookedMeshSourceStamp source;
+    bool hasSource = GetCookedMeshSourceStamp(filepath, source);
+    if (_useCookedCache && hasSource && LoadCookedMesh(cookedPath, source)) {
+        std::cout << "ӻ: " << GetVertexCount() << " , "
+            << GetIndexCount() / 3 << " " << std::endl;
+        return;
+    }
+
+    // ӳļ
+    MappedFile file;
+    if (!file.Open(filepath)) {
         std::cerr << "޷ļ: " << filepath << std::endl;
         return;
     }
 
-    // ȡļݵstringstream
-    std::stringstream buffer;
-    buffer << file.rdbuf();
-    file.close();
+    // OBJļп߳̽봮·λһ
+    unsigned int threadCount = _loadThreadCount;
+    if (threadCount == 0) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
 
-    // OBJ
-    ParseObjFile(buffer);
+    const char* data = file.GetData();
+    if (threadCount > 1 && file.GetSize() >= ParallelLoadMinBytes) {
+        ParseObjFileParallel(data, data + file.GetSize(), threadCount);
+    }
+    else {
+        ParseObjFile(data, data + file.GetSize());
+    }
+
+    ComputeBounds();
+
+    std::cout << ": " << _verticeArray.size() << " , "
+        << _indexArray.size() / 3 << " " << std::endl;
 
-    std::cout << ": " << _verticeArray.size() << " " << std::endl;
+    // д湩´ʹ
+    if (_useCookedCache && hasSource) {
+        if (!WriteCookedMesh(cookedPath, _verticeArray.data(), _verticeArray.size(),
+            _indexArray.data(), _indexArray.size(), _boundsMin, _boundsMax, source)) {
+            std::cerr << "棺޷д뻺ļ: " << cookedPath << std::endl;
+        }
+    }
 }
 
-void Mesh::ParseObjFile(std::stringstream& ss)
+void Mesh::ParseObjFile(const char* begin, const char* end)
 {
+    PROFILE_ZONE("Mesh::ParseObjFile");
     std::vector<Vector3> tempPositions;  // ʱ洢λ
-    std::string line;
+    std::vector<ObjCorner> corners;      // νǵ㣨תΪ0ʼ
+
+    // 渴õʱ
+    std::vector<FaceToken> tokens;
+    std::vector<ObjCorner> faceCorners;
+    std::vector<Vector3> facePoints;
+    TriangulationScratch scratch;
+
+    const char* p = begin;
+    while (p < end) {
+        const char* lineEnd = static_cast<const char*>(std::memchr(p, '\n', end - p));
+        if (lineEnd == nullptr) {
+            lineEnd = end;
+        }
+
+        const char* cur = SkipBlanks(p, lineEnd);
+        p = lineEnd + 1;
 
-    while (std::getline(ss, line)) {
         // кע
-        if (line.empty() || line[0] == '#') {
+        if (cur == lineEnd || *cur == '#') {
             continue;
         }
 
-        std::stringstream lineStream(line);
-        std::string prefix;
-        lineStream >> prefix;
+        const char* prefixEnd = SkipToken(cur, lineEnd);
+        size_t prefixLength = prefixEnd - cur;
 
-        if (prefix == "v") {  // λ
+        if (prefixLength == 1 && *cur == 'v') {  // λ
             float x, y, z;
-            if (lineStream >> x >> y >> z) {
+            const char* next = ParseFloat(prefixEnd, lineEnd, x);
+            if (next) next = ParseFloat(next, lineEnd, y);
+            if (next) next = ParseFloat(next, lineEnd, z);
+            if (next) {
                 tempPositions.push_back(Vector3(x, y, z));
             }
         }
-        else if (prefix == "f") {  // 
-            // λı
-            std::vector<std::string> faceTokens;
-            std::string token;
+        else if (prefixLength == 1 && *cur == 'f') {  // 
+            // 棬tokenֱָӳڴ
+            TokenizeFace(prefixEnd, lineEnd, tokens);
+            if (tokens.size() < 3) {
+                continue;
+            }
 
-            while (lineStream >> token) {
-                faceTokens.push_back(token);
+            // һǵЧʱ޷ǻ
+            bool faceValid = true;
+            faceCorners.clear();
+            for (const FaceToken& token : tokens) {
+                ObjCorner corner;
+                if (ParseFace(token.begin, token.end, tempPositions.size(), corner)) {
+                    faceCorners.push_back(corner);
+                }
+                else {
+                    faceValid = false;
+                }
             }
 
-            // ı棺ǻΪ
-            if (faceTokens.size() == 4) {
-                // 1: v0, v1, v2
-                ParseFace(faceTokens[0], tempPositions);
-                ParseFace(faceTokens[1], tempPositions);
-                ParseFace(faceTokens[2], tempPositions);
-
-                // 2: v0, v2, v3
-                ParseFace(faceTokens[0], tempPositions);
-                ParseFace(faceTokens[2], tempPositions);
-                ParseFace(faceTokens[3], tempPositions);
+            if (faceValid) {
+                TriangulateFace(faceCorners.data(), faceCorners.size(), tempPositions, facePoints, scratch, corners);
             }
         }
         // (vt, vn, usemtl)
     }
+
+    BuildIndexedMesh(tempPositions, corners);
 }
 
-void Mesh::ParseFace(const std::string& token,
-    const std::vector<Vector3>& tempPositions)
+void Mesh::ParseObjFileParallel(const char* begin, const char* end, unsigned int threadCount)
 {
-    // OBJʽ: "//"  "//"
-    // ֻĶһ֣
+    PROFILE_ZONE("Mesh::ParseObjFileParallel");
+    // 1. б߽п飬߳ƽvкfеĽ
+    size_t chunkCount = static_cast<size_t>(threadCount) * 4;
+    size_t chunkSize = (end - begin) / chunkCount + 1;
+
+    std::vector<ObjChunk> chunks;
+    chunks.reserve(chunkCount);
+    const char* chunkBegin = begin;
+    while (chunkBegin < end) {
+        const char* chunkEnd = chunkBegin + std::min<size_t>(chunkSize, end - chunkBegin);
+        const char* newline = static_cast<const char*>(std::memchr(chunkEnd, '\n', end - chunkEnd));
+        chunkEnd = newline ? newline + 1 : end;
+
+        chunks.emplace_back();
+        chunks.back().begin = chunkBegin;
+        chunks.back().end = chunkEnd;
+        chunkBegin = chunkEnd;
+    }
+
+    // 2. 
+    ParallelFor(chunks.size(), threadCount, [&](size_t i) {
+        ParseObjChunk(chunks[i]);
+    });
+
+    // 3. ǰ׺ͣϲȫֶ
+    size_t positionCount = 0;
+    for (ObjChunk& chunk : chunks) {
+        chunk.positionOffset = positionCount;
+        positionCount += chunk.positions.size();
+    }
+
+    std::vector<Vector3> tempPositions(positionCount);
+    ParallelFor(chunks.size(), threadCount, [&](size_t i) {
+        std::copy(chunks[i].positions.begin(), chunks[i].positions.end(),
+            tempPositions.begin() + chunks[i].positionOffset);
+    });
+
+    // 4. Уǵ㲢ǻҪȫֶԷںϲ֮
+    ParallelFor(chunks.size(), threadCount, [&](size_t i) {
+        ObjChunk& chunk = chunks[i];
+        PositionLimitCursor limits(chunk);
+        std::vector<ObjCorner> faceCorners;
+        std::vector<Vector3> facePoints;
+        TriangulationScratch scratch;
+
+        size_t cornerIndex = 0;
+        for (uint32_t faceSize : chunk.faceSizes) {
+            bool faceValid = true;
+            faceCorners.clear();
+            for (uint32_t k = 0; k < faceSize; ++k, ++cornerIndex) {
+                ObjCorner corner = chunk.corners[cornerIndex];
+                if (IsValidCorner(corner.position, limits.At(cornerIndex))) {
+                    corner.position -= 1;
+                    faceCorners.push_back(corner);
+                }
+                else {
+                    faceValid = false;
+                }
+            }
+
+            if (faceValid) {
+                TriangulateFace(faceCorners.data(), faceCorners.size(), tempPositions, facePoints, scratch, chunk.triangles);
+            }
+            else {
+                chunk.hasErrors = true;
+            }
+        }
+    });
+
+    // 5. νǵǰ׺ͣдλ
+    size_t outputCount = 0;
+    for (ObjChunk& chunk : chunks) {
+        chunk.outputOffset = outputCount;
+        outputCount += chunk.triangles.size();
+    }
+
+    std::vector<ObjCorner> corners(outputCount);
+    ParallelFor(chunks.size(), threadCount, [&](size_t i) {
+        std::copy(chunks[i].triangles.begin(), chunks[i].triangles.end(),
+            corners.begin() + chunks[i].outputOffset);
+    });
 
-    // ҵһб
-    size_t slashPos = token.find('/');
-    std::string vertexPart = token;
+    // 6. ļ˳Ϣ봮·һ
+    for (const ObjChunk& chunk : chunks) {
+        if (!chunk.hasErrors) {
+            continue;
+        }
 
-    if (slashPos != std::string::npos) {
-        vertexPart = token.substr(0, slashPos);
+        PositionLimitCursor limits(chunk);
+        size_t failedIndex = 0;
+        for (size_t corner = 0; corner < chunk.corners.size(); ++corner) {
+            int value = chunk.corners[corner].position;
+            if (value == INT_MIN) {
+                std::cerr << "󣺽ʧ: " << chunk.failedTokens[failedIndex++] << std::endl;
+            }
+            else if (!IsValidCorner(value, limits.At(corner))) {
+                std::cerr << "棺Χ: " << static_cast<long long>(value) - 1 << std::endl;
+            }
+        }
     }
 
-    try {
-        // OBJ1ʼC++0ʼ
-        int idx = std::stoi(vertexPart) - 1;
+    // 7. ȥأУ֤˳봮·һ£
+    BuildIndexedMesh(tempPositions, corners);
+}
 
-        if (idx >= 0 && idx < static_cast<int>(tempPositions.size())) {
-            _verticeArray.push_back(tempPositions[idx]);
+void Mesh::BuildIndexedMesh(const std::vector<Vector3>& positions, const std::vector<ObjCorner>& corners)
+{
+    PROFILE_ZONE("Mesh::BuildIndexedMesh");
+    // ԶΪͰϣͬһλòͬvt/vnĽǵͰ
+    // õĶļͨڣλ÷ͰͨùϣķôֲԺõö
+    const uint32_t EmptySlot = UINT32_MAX;
+    std::vector<uint32_t> bucketHeads(positions.size(), EmptySlot);
+    std::vector<uint32_t> nextInBucket;
+    std::vector<ObjCorner> uniqueCorners;
+    nextInBucket.reserve(positions.size());
+    uniqueCorners.reserve(positions.size());
+
+    _verticeArray.clear();
+    _verticeArray.reserve(positions.size());
+    _indexArray.resize(corners.size());
+
+    for (size_t i = 0; i < corners.size(); ++i) {
+        const ObjCorner& corner = corners[i];
+        uint32_t vertexIndex = bucketHeads[corner.position];
+        while (vertexIndex != EmptySlot && !SameCorner(uniqueCorners[vertexIndex], corner)) {
+            vertexIndex = nextInBucket[vertexIndex];
         }
-        else {
-            std::cerr << "棺Χ: " << idx << std::endl;
+
+        if (vertexIndex == EmptySlot) {
+            vertexIndex = static_cast<uint32_t>(uniqueCorners.size());
+            nextInBucket.push_back(bucketHeads[corner.position]);
+            bucketHeads[corner.position] = vertexIndex;
+            uniqueCorners.push_back(corner);
+            _verticeArray.push_back(positions[corner.position]);
         }
+        _indexArray[i] = vertexIndex;
     }
-    catch (const std::exception& e) {
-        std::cerr << "󣺽ʧ: " << token << std::endl;
+}
+
+bool Mesh::ParseFace(const char* begin, const char* end,
+    size_t positionCount, ObjCorner& corner)
+{
+    if (!ParseFaceCorner(begin, end, corner)) {
+        std::cerr << "󣺽ʧ: " << std::string(begin, end) << std::endl;
+        return false;
     }
+
+    // OBJ1ʼC++0ʼ
+    long long idx = static_cast<long long>(corner.position) - 1;
+
+    if (idx >= 0 && idx < static_cast<long long>(positionCount)) {
+        corner.position = static_cast<int>(idx);
+        return true;
+    }
+
+    std::cerr << "棺Χ: " << idx << std::endl;
+    return false;
 }
\ No newline at end of file
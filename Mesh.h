@@ -1,6 +1,20 @@
+#pragma once
 #include <vector>
 #include <string>
+#include <cstdint>
 #include "Vector3.h"
+#include "Core/MappedFile.h"
+
+struct CookedMeshHeader;
+struct CookedMeshSourceStamp;
+
+// OBJһǵ㣺v/vt/vnԪ飬Ϊȥصļ
+struct ObjCorner
+{
+    int position;  // 
+    int texcoord;  // 0ʾȱʧ
+    int normal;    // 0ʾȱʧ
+};
 
 class Mesh
 {
@@ -10,18 +24,59 @@ public:
     // ļ
     void LoadMeshFromPath(const std::string& filepath);
 
-    //// ȡ
-    std::vector<Vector3> GetVertices(){ return _verticeArray; }
-    std::vector<float> GetVerticesFloat();
+    // üOBJʹõ߳0ΪCPUԶѡ1Ϊн
+    void SetLoadThreadCount(unsigned int threadCount);
+
+    // Ƿʹú決(.cmesh)ĬϿ
+    void SetUseCookedCache(bool useCookedCache);
+
+    //// ȡݣȥغΨһ㣩
+    std::vector<Vector3> GetVertices() const;
+    std::vector<float> GetVerticesFloat() const;
+
+    // ȡÿ3һ
+    std::vector<uint32_t> GetIndices() const;
+
+    // ֱӷʶݣӻʱָӳڴ棬ֱӽglBufferData
+    const Vector3* GetVertexData() const;
+    size_t GetVertexCount() const;
+    const uint32_t* GetIndexData() const;
+    size_t GetIndexCount() const;
+
+    // Χ
+    const Vector3& GetBoundsMin() const { return _boundsMin; }
+    const Vector3& GetBoundsMax() const { return _boundsMax; }
 
 private:
-    // OBJļ
-    void ParseObjFile(std::stringstream& ss);
+    // ӳ決棬𻵻Դļһʱfalse
+    bool LoadCookedMesh(const std::string& cookedPath, const CookedMeshSourceStamp& source);
+
+    // Χ
+    void ComputeBounds();
+
+    // OBJļֱӳڴԭؽ
+    void ParseObjFile(const char* begin, const char* end);
+
+    // п鲢нOBJļParseObjFileλһ
+    void ParseObjFileParallel(const char* begin, const char* end, unsigned int threadCount);
 
-    //
-    void ParseFace(const std::string& token,
-        const std::vector<Vector3>& tempPositions);
+    //һǵ㣬tokenΪ[begin, end)䣬Чʱϲfalse
+    bool ParseFace(const char* begin, const char* end,
+        size_t positionCount, ObjCorner& corner);
+
+    // v/vt/vnȥأΨһ
+    void BuildIndexedMesh(const std::vector<Vector3>& positions, const std::vector<ObjCorner>& corners);
 
 private:
-    std::vector<Vector3> _verticeArray;  // λ
+    std::vector<Vector3> _verticeArray;  // λ飨Ψһ㣩
+    std::vector<uint32_t> _indexArray;   // 
+    unsigned int _loadThreadCount;       // ߳
+    bool _useCookedCache;                // Ƿʹú決
+
+    // ӻʱֱָӳļ
+    MappedFile _cookedFile;
+    const CookedMeshHeader* _cookedHeader;
+
+    Vector3 _boundsMin;
+    Vector3 _boundsMax;
 };
\ No newline at end of file
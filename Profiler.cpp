@@ -0,0 +1,275 @@
+﻿#include "Core/Profiler.h"
+#include "Core/CpuFeatures.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+std::atomic<bool> Profiler::s_Enabled(true);
+bool Profiler::s_UseTsc = false;
+
+// 一个线程的环形缓冲，只有所属线程写
+// 记录的字段是relaxed原子变量：读取方可能读到正在被覆盖的记录，之后按写入计数丢掉，但不能是未定义行为
+class ProfileThreadBuffer
+{
+public:
+    struct Slot
+    {
+        std::atomic<const ProfileZoneInfo*> zone;
+        std::atomic<uint64_t> begin;
+        std::atomic<uint64_t> end;
+        std::atomic<uint32_t> depth;
+    };
+
+    Slot slots[Profiler::EventCapacity];
+    std::atomic<uint64_t> writeCount;   // 已写入的记录总数，第i条在slots[i % EventCapacity]
+    unsigned int index;
+    char name[32];          // 由m_BuffersMutex保护
+
+    ProfileThreadBuffer() : writeCount(0), index(0) { name[0] = '\0'; }
+};
+
+static_assert((Profiler::EventCapacity & (Profiler::EventCapacity - 1)) == 0, "EventCapacity必须是2的幂");
+
+// 线程退出时归还缓冲
+struct ProfileThreadBufferOwner
+{
+    ~ProfileThreadBufferOwner()
+    {
+        if (Profiler::t_Buffer)
+            GetProfiler().ReleaseBuffer(Profiler::t_Buffer);
+        Profiler::t_Buffer = nullptr;
+    }
+};
+static thread_local ProfileThreadBufferOwner t_BufferOwner;
+
+ProfileThreadBuffer* Profiler::AcquireThreadBuffer()
+{
+    (void)&t_BufferOwner;   // 第一次访问时注册线程退出时的析构
+    ProfileThreadBuffer* buffer = GetProfiler().AcquireBuffer();
+    t_Buffer = buffer;
+    return buffer;
+}
+
+static double SteadySeconds()
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+Profiler& GetProfiler()
+{
+    static Profiler* profiler = new Profiler();
+    return *profiler;
+}
+
+Profiler::Profiler()
+    : m_UseTsc(false), m_StartTicks(0), m_StartSeconds(0.0), m_MicrosecondsPerTick(0.0), m_FrameCount(0)
+{
+    std::memset(m_FrameStarts, 0, sizeof(m_FrameStarts));
+#ifdef CENGINE_PROFILER_TSC
+    m_UseTsc = GetCpuFeatures().invariantTsc;
+#endif
+    s_UseTsc = m_UseTsc;
+
+    typedef std::chrono::steady_clock::period Period;
+    m_MicrosecondsPerTick = 1e6 * Period::num / Period::den;
+    m_StartSeconds = SteadySeconds();
+    m_StartTicks = Now();
+    if (m_UseTsc)
+    {
+        // 先粗略校准一次，之后随着基线变长越来越准
+        while (SteadySeconds() - m_StartSeconds < 0.002) {}
+        m_MicrosecondsPerTick = 0.0;
+        Calibrate();
+    }
+}
+
+void Profiler::Calibrate()
+{
+    if (!m_UseTsc)
+        return;
+    double elapsed = SteadySeconds() - m_StartSeconds;
+    uint64_t ticks = Now() - m_StartTicks;
+    if (ticks > 0 && (elapsed >= 0.01 || m_MicrosecondsPerTick == 0.0))
+        m_MicrosecondsPerTick = elapsed * 1e6 / static_cast<double>(ticks);
+}
+
+ProfileThreadBuffer* Profiler::AcquireBuffer()
+{
+    std::lock_guard<std::mutex> lock(m_BuffersMutex);
+    ProfileThreadBuffer* buffer;
+    if (!m_FreeBuffers.empty())
+    {
+        buffer = m_FreeBuffers.back();
+        m_FreeBuffers.pop_back();
+    }
+    else
+    {
+        buffer = new ProfileThreadBuffer();
+        buffer->index = static_cast<unsigned int>(m_Buffers.size());
+        std::snprintf(buffer->name, sizeof(buffer->name), "Thread %u", buffer->index);
+        m_Buffers.push_back(buffer);
+    }
+    return buffer;
+}
+
+void Profiler::ReleaseBuffer(ProfileThreadBuffer* buffer)
+{
+    std::lock_guard<std::mutex> lock(m_BuffersMutex);
+    m_FreeBuffers.push_back(buffer);
+}
+
+void Profiler::SetThreadName(const char* name)
+{
+    ProfileThreadBuffer* buffer = GetThreadBuffer();
+    std::lock_guard<std::mutex> lock(m_BuffersMutex);
+    std::snprintf(buffer->name, sizeof(buffer->name), "%s", name);
+}
+
+void Profiler::Record(ProfileThreadBuffer* buffer, const ProfileZoneInfo* zone, uint64_t begin, uint64_t end, uint32_t depth)
+{
+    uint64_t count = buffer->writeCount.load(std::memory_order_relaxed);
+
+    // 读取方看到这条记录的任何字段时，也一定能看到之前的写入计数（见Capture）
+    std::atomic_thread_fence(std::memory_order_release);
+    ProfileThreadBuffer::Slot& slot = buffer->slots[count & (EventCapacity - 1)];
+    slot.zone.store(zone, std::memory_order_relaxed);
+    slot.begin.store(begin, std::memory_order_relaxed);
+    slot.end.store(end, std::memory_order_relaxed);
+    slot.depth.store(depth, std::memory_order_relaxed);
+    buffer->writeCount.store(count + 1, std::memory_order_release);
+}
+
+void Profiler::MarkFrame()
+{
+    m_FrameStarts[m_FrameCount % FrameHistory] = Now();
+    ++m_FrameCount;
+}
+
+bool Profiler::GetFrameRange(int n, uint64_t& begin, uint64_t& end) const
+{
+    if (n < 0 || n + 2 > FrameHistory || m_FrameCount < static_cast<uint64_t>(n) + 2)
+        return false;
+    uint64_t frame = m_FrameCount - 2 - n;
+    begin = m_FrameStarts[frame % FrameHistory];
+    end = m_FrameStarts[(frame + 1) % FrameHistory];
+    return true;
+}
+
+void Profiler::Capture(uint64_t begin, uint64_t end, std::vector<ProfileThreadCapture>& captures)
+{
+    Calibrate();
+
+    std::lock_guard<std::mutex> lock(m_BuffersMutex);
+    captures.resize(m_Buffers.size());
+    for (size_t b = 0; b < m_Buffers.size(); ++b)
+    {
+        ProfileThreadBuffer& buffer = *m_Buffers[b];
+        ProfileThreadCapture& capture = captures[b];
+        capture.threadIndex = buffer.index;
+        std::memcpy(capture.threadName, buffer.name, sizeof(capture.threadName));
+        capture.events.clear();
+        m_CaptureIndices.clear();
+
+        // 同一线程的记录按结束时间递增，从最新往回读，结束时间早于begin就停
+        uint64_t written = buffer.writeCount.load(std::memory_order_acquire);
+        uint64_t oldest = written > EventCapacity ? written - EventCapacity : 0;
+        for (uint64_t i = written; i > oldest; --i)
+        {
+            const ProfileThreadBuffer::Slot& slot = buffer.slots[(i - 1) & (EventCapacity - 1)];
+            ProfileEvent event;
+            event.zone = slot.zone.load(std::memory_order_relaxed);
+            event.begin = slot.begin.load(std::memory_order_relaxed);
+            event.end = slot.end.load(std::memory_order_relaxed);
+            event.depth = slot.depth.load(std::memory_order_relaxed);
+            if (event.end < begin)
+                break;
+            if (event.begin > end)
+                continue;
+            capture.events.push_back(event);
+            m_CaptureIndices.push_back(i - 1);
+        }
+
+        // 读的过程中写入方又写了若干条：序号不大于 新计数 - 容量 的槽位可能已被覆盖
+        std::atomic_thread_fence(std::memory_order_acquire);
+        uint64_t after = buffer.writeCount.load(std::memory_order_relaxed);
+        uint64_t valid = after + 1 > EventCapacity ? after + 1 - EventCapacity : 0;
+        size_t keep = 0;
+        while (keep < m_CaptureIndices.size() && m_CaptureIndices[keep] >= valid)
+            ++keep;
+        capture.events.resize(keep);
+        std::reverse(capture.events.begin(), capture.events.end());
+    }
+}
+
+// JSON字符串转义；MSVC的__FILE__里有反斜杠
+static void WriteJsonString(std::ofstream& file, const char* text)
+{
+    file << '"';
+    for (const char* p = text; *p; ++p)
+    {
+        char c = *p;
+        if (c == '"' || c == '\\')
+            file << '\\' << c;
+        else if (static_cast<unsigned char>(c) < 0x20)
+        {
+            char escaped[8];
+            std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned char>(c));
+            file << escaped;
+        }
+        else
+            file << c;
+    }
+    file << '"';
+}
+
+bool Profiler::ExportChromeTrace(const char* path)
+{
+    std::vector<ProfileThreadCapture> captures;
+    Capture(0, UINT64_MAX, captures);
+
+    std::ofstream file(path, std::ios::trunc);
+    if (!file)
+    {
+        std::cerr << "错误：无法写入trace文件: " << path << std::endl;
+        return false;
+    }
+
+    // 完整事件（ph为X），时间单位为微秒
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    file.setf(std::ios::fixed);
+    file.precision(3);
+    bool first = true;
+    size_t eventCount = 0;
+    for (const ProfileThreadCapture& capture : captures)
+    {
+        if (capture.events.empty())
+            continue;
+        file << (first ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << capture.threadIndex << ",\"args\":{\"name\":";
+        WriteJsonString(file, capture.threadName);
+        file << "}}";
+        first = false;
+        for (const ProfileEvent& event : capture.events)
+        {
+            file << ",\n{\"name\":";
+            WriteJsonString(file, event.zone->name);
+            file << ",\"cat\":\"cpu\",\"ph\":\"X\",\"pid\":1,\"tid\":" << capture.threadIndex
+                << ",\"ts\":" << ToMicroseconds(event.begin) << ",\"dur\":" << TicksToMilliseconds(event.end - event.begin) * 1000.0
+                << ",\"args\":{\"file\":";
+            WriteJsonString(file, event.zone->file);
+            file << ",\"line\":" << event.zone->line << "}}";
+        }
+        eventCount += capture.events.size();
+    }
+    file << "\n]}\n";
+
+    if (!file)
+    {
+        std::cerr << "错误：写入trace文件失败: " << path << std::endl;
+        return false;
+    }
+    std::cout << "已导出 " << eventCount << " 条记录到 " << path << std::endl;
+    return true;
+}
\ No newline at end of file
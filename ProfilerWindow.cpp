@@ -0,0 +1,134 @@
+﻿#include "Core/ProfilerWindow.h"
+#include "Core/StringHash.h"
+#include "imgui.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+ProfilerWindow::ProfilerWindow()
+    : m_FrameBegin(0), m_FrameEnd(0), m_Paused(false), m_Zoom(1.0f)
+{
+    std::snprintf(m_ExportPath, sizeof(m_ExportPath), "%s", "profile.json");
+    m_ExportStatus[0] = '\0';
+}
+
+// 同名的区颜色相同，亮度固定，只按名字的哈希换色相
+static ImU32 ZoneColor(const char* name)
+{
+    float hue = (HashString(name) % 360) / 360.0f;
+    float r, g, b;
+    ImGui::ColorConvertHSVtoRGB(hue, 0.45f, 0.85f, r, g, b);
+    return ImGui::GetColorU32(ImVec4(r, g, b, 1.0f));
+}
+
+void ProfilerWindow::Draw(bool* open)
+{
+    if (!*open)
+        return;
+    if (!ImGui::Begin("Profiler", open))
+    {
+        ImGui::End();
+        return;
+    }
+
+    Profiler& profiler = GetProfiler();
+    bool enabled = Profiler::IsEnabled();
+    if (ImGui::Checkbox("Enabled", &enabled))
+        Profiler::SetEnabled(enabled);
+    ImGui::SameLine();
+    ImGui::Checkbox("Pause", &m_Paused);
+    ImGui::SameLine();
+    ImGui::SetNextItemWidth(150.0f);
+    ImGui::SliderFloat("Zoom", &m_Zoom, 1.0f, 50.0f, "%.1fx", ImGuiSliderFlags_Logarithmic);
+
+    ImGui::SetNextItemWidth(250.0f);
+    ImGui::InputText("##ExportPath", m_ExportPath, sizeof(m_ExportPath));
+    ImGui::SameLine();
+    if (ImGui::Button("Export Chrome trace"))
+    {
+        bool exported = profiler.ExportChromeTrace(m_ExportPath);
+        std::snprintf(m_ExportStatus, sizeof(m_ExportStatus), exported ? "Exported to %s" : "Failed to write %s", m_ExportPath);
+    }
+    if (m_ExportStatus[0])
+    {
+        ImGui::SameLine();
+        ImGui::TextUnformatted(m_ExportStatus);
+    }
+
+    // 暂停时保留上次读出的那一帧
+    uint64_t begin, end;
+    if (!m_Paused && profiler.GetFrameRange(0, begin, end))
+    {
+        m_FrameBegin = begin;
+        m_FrameEnd = end;
+        profiler.Capture(begin, end, m_Captures);
+    }
+    if (m_FrameEnd <= m_FrameBegin)
+    {
+        ImGui::Text("No complete frame recorded yet");
+        ImGui::End();
+        return;
+    }
+
+    size_t eventCount = 0;
+    for (const ProfileThreadCapture& capture : m_Captures)
+        eventCount += capture.events.size();
+    double frameMilliseconds = profiler.TicksToMilliseconds(m_FrameEnd - m_FrameBegin);
+    ImGui::Text("Frame %.3f ms, %zu zones on %zu threads, clock %s", frameMilliseconds, eventCount, m_Captures.size(),
+        profiler.IsUsingTsc() ? "rdtsc" : "steady_clock");
+
+    // 火焰图：横向可滚动，每个线程一段，每层嵌套一行
+    const float rowHeight = ImGui::GetTextLineHeight() + 4.0f;
+    ImGui::BeginChild("FlameGraph", ImVec2(0.0f, 0.0f), ImGuiChildFlags_Borders, ImGuiWindowFlags_HorizontalScrollbar);
+    float width = std::max(ImGui::GetContentRegionAvail().x, 100.0f) * m_Zoom;
+    double pixelsPerTick = width / static_cast<double>(m_FrameEnd - m_FrameBegin);
+    ImDrawList* drawList = ImGui::GetWindowDrawList();
+    ImU32 textColor = ImGui::GetColorU32(ImVec4(0.0f, 0.0f, 0.0f, 1.0f));
+    ImU32 borderColor = ImGui::GetColorU32(ImVec4(0.0f, 0.0f, 0.0f, 0.35f));
+
+    for (const ProfileThreadCapture& capture : m_Captures)
+    {
+        if (capture.events.empty())
+            continue;
+        ImGui::TextUnformatted(capture.threadName);
+
+        uint32_t maxDepth = 0;
+        for (const ProfileEvent& event : capture.events)
+            maxDepth = std::max(maxDepth, event.depth);
+
+        ImVec2 origin = ImGui::GetCursorScreenPos();
+        ImGui::Dummy(ImVec2(width, rowHeight * (maxDepth + 1)));
+        bool laneHovered = ImGui::IsItemHovered();
+        ImVec2 mouse = ImGui::GetIO().MousePos;
+
+        for (const ProfileEvent& event : capture.events)
+        {
+            // 跨帧边界的区截断到帧内
+            uint64_t eventBegin = std::max(event.begin, m_FrameBegin);
+            uint64_t eventEnd = std::min(event.end, m_FrameEnd);
+            float x0 = origin.x + static_cast<float>((eventBegin - m_FrameBegin) * pixelsPerTick);
+            float x1 = origin.x + static_cast<float>((eventEnd - m_FrameBegin) * pixelsPerTick);
+            x1 = std::max(x1, x0 + 1.0f);
+            float y0 = origin.y + event.depth * rowHeight;
+            float y1 = y0 + rowHeight - 1.0f;
+
+            drawList->AddRectFilled(ImVec2(x0, y0), ImVec2(x1, y1), ZoneColor(event.zone->name));
+            drawList->AddRect(ImVec2(x0, y0), ImVec2(x1, y1), borderColor);
+            float textWidth = ImGui::CalcTextSize(event.zone->name).x;
+            if (x1 - x0 > textWidth + 6.0f)
+                drawList->AddText(ImVec2(x0 + 3.0f, y0 + 2.0f), textColor, event.zone->name);
+
+            if (laneHovered && mouse.x >= x0 && mouse.x < x1 && mouse.y >= y0 && mouse.y < y1)
+            {
+                ImGui::BeginTooltip();
+                ImGui::Text("%s", event.zone->name);
+                ImGui::Text("%.3f ms", profiler.TicksToMilliseconds(event.end - event.begin));
+                ImGui::Text("%s:%d", event.zone->file, event.zone->line);
+                ImGui::EndTooltip();
+            }
+        }
+        ImGui::Spacing();
+    }
+    ImGui::EndChild();
+    ImGui::End();
+}
\ No newline at end of file
@@ -0,0 +1,25 @@
+﻿#include "Graphics/RenderCommandList.h"
+
+void* RenderCommandList::Push(CommandFunction function, size_t size, size_t alignment)
+{
+    size_t offset = (m_Data.size() + alignment - 1) & ~(alignment - 1);
+    m_Data.resize(offset + size);
+    Command command = { function, offset, size };
+    m_Commands.push_back(command);
+    return m_Data.data() + offset;
+}
+
+void RenderCommandList::Execute() const
+{
+    for (size_t i = 0; i < m_Commands.size(); ++i)
+    {
+        const Command& command = m_Commands[i];
+        command.function(command.size ? m_Data.data() + command.offset : nullptr);
+    }
+}
+
+void RenderCommandList::Reset()
+{
+    m_Commands.clear();
+    m_Data.clear();
+}
\ No newline at end of file
@@ -0,0 +1,149 @@
+﻿#include "Graphics/RenderQueue.h"
+#include "Graphics/GLStateCache.h"
+#include "Graphics/Shader.h"
+#include "Core/Profiler.h"
+#include <glad/glad.h>
+#include <chrono>
+#include <cstring>
+
+RenderQueue::RenderQueue()
+    : m_DrawCount(0), m_ProgramChanges(0), m_MaterialChanges(0), m_VertexArrayChanges(0), m_SortMilliseconds(0.0)
+{
+}
+
+// 非负float的位模式与数值同序，取高24位作为深度，精度约为相对值的2^-16
+static uint32_t QuantizeDepth(float depth)
+{
+    if (!(depth > 0.0f))
+        return 0;
+    uint32_t bits;
+    std::memcpy(&bits, &depth, sizeof(bits));
+    return bits >> 7;
+}
+
+uint64_t RenderQueue::MakeSortKey(RenderPass pass, uint32_t shader, uint32_t material, uint32_t vertexArray, float depth)
+{
+    uint64_t key = static_cast<uint64_t>(static_cast<uint32_t>(pass) & 0xF) << 60;
+    uint64_t state = (static_cast<uint64_t>(shader & 0xFFF) << 24) | (static_cast<uint64_t>(material & 0xFFF) << 12) | (vertexArray & 0xFFF);
+    uint64_t quantized = QuantizeDepth(depth);
+    if (pass == RenderPass::Translucent)
+        return key | ((0xFFFFFFull - quantized) << 36) | state;
+    return key | (state << 24) | quantized;
+}
+
+void RenderQueue::Reset()
+{
+    m_Packets.clear();
+    m_Items.clear();
+}
+
+void RenderQueue::Submit(uint64_t key, const DrawPacket& packet)
+{
+    SortItem item = { key, static_cast<uint32_t>(m_Packets.size()) };
+    m_Packets.push_back(packet);
+    m_Items.push_back(item);
+}
+
+void RenderQueue::Sort()
+{
+    size_t count = m_Items.size();
+    if (count < 2)
+        return;
+    m_Scratch.resize(count);
+
+    // 一次遍历统计8个字节的直方图
+    size_t histograms[8][256];
+    std::memset(histograms, 0, sizeof(histograms));
+    for (size_t i = 0; i < count; ++i)
+    {
+        uint64_t key = m_Items[i].key;
+        for (int b = 0; b < 8; ++b)
+            ++histograms[b][(key >> (b * 8)) & 0xFF];
+    }
+
+    SortItem* source = m_Items.data();
+    SortItem* target = m_Scratch.data();
+    for (int b = 0; b < 8; ++b)
+    {
+        size_t* histogram = histograms[b];
+        if (histogram[(source[0].key >> (b * 8)) & 0xFF] == count)
+            continue;
+
+        size_t offset = 0;
+        for (int d = 0; d < 256; ++d)
+        {
+            size_t n = histogram[d];
+            histogram[d] = offset;
+            offset += n;
+        }
+        for (size_t i = 0; i < count; ++i)
+            target[histogram[(source[i].key >> (b * 8)) & 0xFF]++] = source[i];
+        SortItem* swap = source;
+        source = target;
+        target = swap;
+    }
+    if (source != m_Items.data())
+        std::memcpy(m_Items.data(), source, count * sizeof(SortItem));
+}
+
+void RenderQueue::Execute()
+{
+    PROFILE_ZONE("RenderQueue::Execute");
+    auto start = std::chrono::steady_clock::now();
+    Sort();
+    m_SortMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    m_DrawCount = 0;
+    m_ProgramChanges = 0;
+    m_MaterialChanges = 0;
+    m_VertexArrayChanges = 0;
+
+    GLStateCache& state = GetGLStateCache();
+    Shader* shader = nullptr;
+    const RenderMaterial* material = nullptr;
+    unsigned int vertexArray = 0;
+    bool first = true;
+    for (size_t i = 0; i < m_Items.size(); ++i)
+    {
+        const DrawPacket& packet = m_Packets[m_Items[i].index];
+        if (!packet.shader || !packet.material || !packet.shader->IsValid())
+            continue;
+
+        // 换程序后uniform属于新程序，材质的uniform要重新设置
+        if (first || packet.shader != shader)
+        {
+            shader = packet.shader;
+            shader->Bind();
+            material = nullptr;
+            ++m_ProgramChanges;
+        }
+        if (packet.material != material)
+        {
+            material = packet.material;
+            state.SetCapability(GL_DEPTH_TEST, material->depthTest);
+            state.SetCapability(GL_CULL_FACE, material->cullFace);
+            if (material->cullFace)
+            {
+                state.FrontFace(material->frontFace);
+                state.CullFace(material->cullMode);
+            }
+            if (material->setUniforms)
+                material->setUniforms(*shader, material->context);
+            ++m_MaterialChanges;
+        }
+        if (first || packet.vertexArray != vertexArray)
+        {
+            vertexArray = packet.vertexArray;
+            state.BindVertexArray(vertexArray);
+            ++m_VertexArrayChanges;
+        }
+        first = false;
+
+        if (packet.setUniforms)
+            packet.setUniforms(*shader, packet.context);
+        glDrawElements(packet.primitive, packet.indexCount, packet.indexType, (void*)packet.indexOffset);
+        ++m_DrawCount;
+    }
+
+    Reset();
+}
\ No newline at end of file
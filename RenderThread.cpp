@@ -0,0 +1,112 @@
+﻿#include "Core/RenderThread.h"
+#include "Graphics/GLStateCache.h"
+#include "Core/Profiler.h"
+#include <chrono>
+
+RenderThread::RenderThread()
+    : m_SetContextCurrent(nullptr), m_Present(nullptr), m_User(nullptr),
+    m_SubmittedCount(0), m_CompletedCount(0), m_Quit(false), m_WaitMilliseconds(0.0), m_ReplayMilliseconds(0.0)
+{
+    for (int i = 0; i < 2; ++i)
+    {
+        m_Packets[i].swapInterval = 0;
+        m_Packets[i].replayMilliseconds = 0.0;
+    }
+}
+
+RenderThread::~RenderThread()
+{
+    Stop();
+}
+
+void RenderThread::Start(ContextFunction setContextCurrent, PresentFunction present, void* user)
+{
+    if (IsRunning())
+        return;
+    m_SetContextCurrent = setContextCurrent;
+    m_Present = present;
+    m_User = user;
+    m_Quit = false;
+    m_Thread = std::thread(&RenderThread::ThreadMain, this);
+}
+
+void RenderThread::Stop()
+{
+    if (!IsRunning())
+        return;
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Quit = true;
+    }
+    m_SubmittedCondition.notify_one();
+    m_Thread.join();
+}
+
+FramePacket& RenderThread::BeginFrame()
+{
+    PROFILE_ZONE("WaitForRenderThread");
+    auto start = std::chrono::steady_clock::now();
+    {
+        // 这一帧用的包两帧前用过：已完成的帧数至少为已提交数 - 1
+        std::unique_lock<std::mutex> lock(m_Mutex);
+        m_CompletedCondition.wait(lock, [this] { return m_CompletedCount + 1 >= m_SubmittedCount; });
+    }
+    m_WaitMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    FramePacket& packet = m_Packets[m_SubmittedCount % 2];
+    m_ReplayMilliseconds = packet.replayMilliseconds;
+    return packet;
+}
+
+void RenderThread::SubmitFrame()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        ++m_SubmittedCount;
+    }
+    m_SubmittedCondition.notify_one();
+}
+
+void RenderThread::Flush()
+{
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    m_CompletedCondition.wait(lock, [this] { return m_CompletedCount == m_SubmittedCount; });
+}
+
+void RenderThread::ThreadMain()
+{
+    GetProfiler().SetThreadName("Render");
+    m_SetContextCurrent(m_User, true);
+    for (;;)
+    {
+        uint64_t frame;
+        {
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            m_SubmittedCondition.wait(lock, [this] { return m_Quit || m_CompletedCount < m_SubmittedCount; });
+            // 退出前把已提交的帧都回放完
+            if (m_CompletedCount == m_SubmittedCount)
+                break;
+            frame = m_CompletedCount;
+        }
+
+        FramePacket& packet = m_Packets[frame % 2];
+        auto start = std::chrono::steady_clock::now();
+        {
+            PROFILE_ZONE("ReplayFrame");
+            GetGLStateCache().BeginFrame();
+            packet.commands.Execute();
+        }
+        packet.replayMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        {
+            PROFILE_ZONE("Present");
+            m_Present(m_User, packet.swapInterval);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            ++m_CompletedCount;
+        }
+        m_CompletedCondition.notify_all();
+    }
+    m_SetContextCurrent(m_User, false);
+}
\ No newline at end of file
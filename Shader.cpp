@@ -1,60 +1,151 @@
 #include "Graphics/Shader.h"
 #include <glad/glad.h>
+#include "Graphics/GLExtensions.h"
 #include <iostream>
 #include <vector>
+#include "Math/Mat4.h"
+#include "Graphics/ShaderCache.h"
+#include "Graphics/GLStateCache.h"
+#include <chrono>
 
-Shader::Shader(const char* vertexSource, const char* fragmentSource)
-    : m_ID(0)
+// ֧GL_KHR/ARB_parallel_shader_compileʱԲزѯǷ
+#ifndef GL_COMPLETION_STATUS_KHR
+#define GL_COMPLETION_STATUS_KHR 0x91B1
+#endif
+typedef void (APIENTRYP PFNGLMAXSHADERCOMPILERTHREADSKHRPROC_CE)(GLuint count);
+static bool s_ParallelCompile = false;
+
+bool Shader::EnableParallelCompile()
+{
+    const char* function = nullptr;
+    if (IsGLExtensionSupported("GL_KHR_parallel_shader_compile"))
+        function = "glMaxShaderCompilerThreadsKHR";
+    else if (IsGLExtensionSupported("GL_ARB_parallel_shader_compile"))
+        function = "glMaxShaderCompilerThreadsARB";
+    if (!function)
+        return false;
+
+    PFNGLMAXSHADERCOMPILERTHREADSKHRPROC_CE maxThreads = reinterpret_cast<PFNGLMAXSHADERCOMPILERTHREADSKHRPROC_CE>(GetGLProcAddress(function));
+    if (!maxThreads)
+        return false;
+
+    // 0xFFFFFFFF߳
+    maxThreads(0xFFFFFFFFu);
+    s_ParallelCompile = true;
+    return true;
+}
+
+bool Shader::IsParallelCompileEnabled()
 {
-    // 1. 붥ɫ
-    unsigned int vertexShader = CompileShader(GL_VERTEX_SHADER, vertexSource);
-    if (vertexShader == 0) return;
+    return s_ParallelCompile;
+}
 
-    // 2. Ƭɫ
-    unsigned int fragmentShader = CompileShader(GL_FRAGMENT_SHADER, fragmentSource);
-    if (fragmentShader == 0)
+Shader::Shader(const char* vertexSource, const char* fragmentSource, ShaderCache* cache, CompileMode mode)
+    : m_ID(0), m_VertexShader(0), m_FragmentShader(0), m_Pending(false), m_Cache(cache), m_CacheKey(0)
+{
+    // 0. Ȳƻ棬ʱҪ
+    if (cache)
     {
-        glDeleteShader(vertexShader);
-        return;
+        m_CacheKey = cache->ComputeKey(vertexSource, fragmentSource);
+        m_ID = cache->LoadProgram(m_CacheKey);
+        if (m_ID != 0)
+        {
+            ReflectUniforms();
+            return;
+        }
     }
+    m_CompileStart = std::chrono::steady_clock::now();
 
-    // 3. ɫ
+    // 1. ύ㡢ƬɫıͳӣȲѯ״̬
+    // ѯ/״̬꣬Finish
+    m_VertexShader = CompileShader(GL_VERTEX_SHADER, vertexSource);
+    m_FragmentShader = CompileShader(GL_FRAGMENT_SHADER, fragmentSource);
+
+    // 2. ɫ
     m_ID = glCreateProgram();
-    glAttachShader(m_ID, vertexShader);
-    glAttachShader(m_ID, fragmentShader);
+    glAttachShader(m_ID, m_VertexShader);
+    glAttachShader(m_ID, m_FragmentShader);
+    if (cache)
+        cache->PrepareProgram(m_ID);
     glLinkProgram(m_ID);
+    m_Pending = true;
+
+    if (mode == CompileMode::Immediate)
+        Finish();
+}
+
+bool Shader::IsReady()
+{
+    if (!m_Pending)
+        return true;
+
+    // ֲ֧бʱ޷֪Ƿֻ꣬ܵ
+    if (s_ParallelCompile)
+    {
+        GLint complete = 0;
+        glGetProgramiv(m_ID, GL_COMPLETION_STATUS_KHR, &complete);
+        if (!complete)
+            return false;
+    }
+    Finish();
+    return true;
+}
+
+void Shader::Finish()
+{
+    if (!m_Pending)
+        return;
+    m_Pending = false;
 
-    // 4. ״̬
-    if (!CheckProgramLinkStatus(m_ID))
+    // 3. ״̬ɹʱд뻺
+    bool compiled = CheckShaderCompileStatus(m_VertexShader, GL_VERTEX_SHADER);
+    compiled = CheckShaderCompileStatus(m_FragmentShader, GL_FRAGMENT_SHADER) && compiled;
+    if (!compiled || !CheckProgramLinkStatus(m_ID))
     {
         glDeleteProgram(m_ID);
         m_ID = 0;
     }
+    else
+    {
+        if (m_Cache)
+        {
+            // ״̬ѯ꣬ĺʱıʱ䣨ӳٱʱύɵʱ䣩
+            double compileMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_CompileStart).count();
+            m_Cache->StoreProgram(m_CacheKey, m_ID, compileMilliseconds);
+        }
+        ReflectUniforms();
+    }
 
-    // 5. ɾɫ
-    glDeleteShader(vertexShader);
-    glDeleteShader(fragmentShader);
+    // 4. ɾɫ
+    glDeleteShader(m_VertexShader);
+    glDeleteShader(m_FragmentShader);
+    m_VertexShader = 0;
+    m_FragmentShader = 0;
 }
 
 Shader::~Shader()
 {
+    if (m_VertexShader != 0)
+        glDeleteShader(m_VertexShader);
+    if (m_FragmentShader != 0)
+        glDeleteShader(m_FragmentShader);
     if (m_ID != 0)
     {
-        glDeleteProgram(m_ID);
+        GetGLStateCache().DeleteProgram(m_ID);
     }
 }
 
 void Shader::Bind() const
 {
-    if (m_ID != 0)
+    if (m_ID != 0 && !m_Pending)
     {
-        glUseProgram(m_ID);
+        GetGLStateCache().UseProgram(m_ID);
     }
 }
 
 void Shader::Unbind() const
 {
-    glUseProgram(0);
+    GetGLStateCache().UseProgram(0);
 }
 
 unsigned int Shader::CompileShader(unsigned int type, const char* source)
@@ -62,14 +153,6 @@ unsigned int Shader::CompileShader(unsigned int type, const char* source)
     unsigned int shader = glCreateShader(type);
     glShaderSource(shader, 1, &source, nullptr);
     glCompileShader(shader);
-
-    // ״̬
-    if (!CheckShaderCompileStatus(shader, type))
-    {
-        glDeleteShader(shader);
-        return 0;
-    }
-
     return shader;
 }
 
@@ -113,4 +196,210 @@ bool Shader::CheckProgramLinkStatus(unsigned int program)
     }
 
     return true;
+}
+
+// ============ uniform ============
+
+void Shader::ReflectUniforms()
+{
+    int count = 0;
+    int maxNameLength = 0;
+    glGetProgramiv(m_ID, GL_ACTIVE_UNIFORMS, &count);
+    glGetProgramiv(m_ID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxNameLength);
+
+    std::vector<char> nameBuffer(maxNameLength > 0 ? maxNameLength : 1);
+    for (int i = 0; i < count; ++i)
+    {
+        int length = 0;
+        int size = 0;
+        GLenum type = 0;
+        glGetActiveUniform(m_ID, static_cast<GLuint>(i), maxNameLength, &length, &size, &type, nameBuffer.data());
+
+        std::string name(nameBuffer.data(), length);
+        if (name.size() > 3 && name.compare(name.size() - 3, 3, "[0]") == 0)
+            name.resize(name.size() - 3);
+
+        // uniformĳԱûλãglUniform*
+        int location = glGetUniformLocation(m_ID, name.c_str());
+        if (location < 0)
+            continue;
+
+        Uniform uniform;
+        uniform.name = name;
+        uniform.hash = HashString(name.c_str());
+        uniform.location = location;
+        uniform.type = type;
+        uniform.size = size;
+        m_Uniforms.push_back(uniform);
+    }
+
+    size_t capacity = 8;
+    while (capacity < m_Uniforms.size() * 2)
+        capacity *= 2;
+    m_UniformSlots.assign(capacity, -1);
+
+    size_t mask = capacity - 1;
+    for (size_t i = 0; i < m_Uniforms.size(); ++i)
+    {
+        size_t slot = m_Uniforms[i].hash & mask;
+        while (m_UniformSlots[slot] >= 0)
+        {
+            if (m_Uniforms[m_UniformSlots[slot]].hash == m_Uniforms[i].hash)
+            {
+                std::cerr << "ERROR::SHADER::UNIFORM_HASH_COLLISION " << m_Uniforms[m_UniformSlots[slot]].name
+                    << " / " << m_Uniforms[i].name << std::endl;
+                break;
+            }
+            slot = (slot + 1) & mask;
+        }
+        if (m_UniformSlots[slot] < 0)
+            m_UniformSlots[slot] = static_cast<int>(i);
+    }
+}
+
+// glUniform1iintbool͸samplerԪţ
+static bool IsSetByUniform1i(unsigned int type)
+{
+    switch (type)
+    {
+    case GL_INT:
+    case GL_BOOL:
+    case GL_SAMPLER_1D:
+    case GL_SAMPLER_2D:
+    case GL_SAMPLER_3D:
+    case GL_SAMPLER_CUBE:
+    case GL_SAMPLER_1D_SHADOW:
+    case GL_SAMPLER_2D_SHADOW:
+    case GL_SAMPLER_1D_ARRAY:
+    case GL_SAMPLER_2D_ARRAY:
+    case GL_SAMPLER_1D_ARRAY_SHADOW:
+    case GL_SAMPLER_2D_ARRAY_SHADOW:
+    case GL_SAMPLER_2D_MULTISAMPLE:
+    case GL_SAMPLER_2D_MULTISAMPLE_ARRAY:
+    case GL_SAMPLER_CUBE_SHADOW:
+    case GL_SAMPLER_BUFFER:
+    case GL_SAMPLER_2D_RECT:
+    case GL_SAMPLER_2D_RECT_SHADOW:
+    case GL_SAMPLER_CUBE_MAP_ARRAY:
+    case GL_SAMPLER_CUBE_MAP_ARRAY_SHADOW:
+    case GL_INT_SAMPLER_1D:
+    case GL_INT_SAMPLER_2D:
+    case GL_INT_SAMPLER_3D:
+    case GL_INT_SAMPLER_CUBE:
+    case GL_INT_SAMPLER_1D_ARRAY:
+    case GL_INT_SAMPLER_2D_ARRAY:
+    case GL_INT_SAMPLER_2D_MULTISAMPLE:
+    case GL_INT_SAMPLER_2D_MULTISAMPLE_ARRAY:
+    case GL_INT_SAMPLER_BUFFER:
+    case GL_INT_SAMPLER_2D_RECT:
+    case GL_INT_SAMPLER_CUBE_MAP_ARRAY:
+    case GL_UNSIGNED_INT_SAMPLER_1D:
+    case GL_UNSIGNED_INT_SAMPLER_2D:
+    case GL_UNSIGNED_INT_SAMPLER_3D:
+    case GL_UNSIGNED_INT_SAMPLER_CUBE:
+    case GL_UNSIGNED_INT_SAMPLER_1D_ARRAY:
+    case GL_UNSIGNED_INT_SAMPLER_2D_ARRAY:
+    case GL_UNSIGNED_INT_SAMPLER_2D_MULTISAMPLE:
+    case GL_UNSIGNED_INT_SAMPLER_2D_MULTISAMPLE_ARRAY:
+    case GL_UNSIGNED_INT_SAMPLER_BUFFER:
+    case GL_UNSIGNED_INT_SAMPLER_2D_RECT:
+    case GL_UNSIGNED_INT_SAMPLER_CUBE_MAP_ARRAY:
+        return true;
+    default:
+        return false;
+    }
+}
+
+const Shader::Uniform* Shader::FindUniform(uint32_t nameHash, unsigned int expectedType) const
+{
+    if (m_UniformSlots.empty())
+        return nullptr;
+
+    size_t mask = m_UniformSlots.size() - 1;
+    for (size_t slot = nameHash & mask; m_UniformSlots[slot] >= 0; slot = (slot + 1) & mask)
+    {
+        const Uniform& uniform = m_Uniforms[m_UniformSlots[slot]];
+        if (uniform.hash != nameHash)
+            continue;
+        // ͲʱglUniform*GL_INVALID_OPERATIONֱ
+        // SetIntglUniform1iboolsampler
+        bool matches = expectedType == GL_INT ? IsSetByUniform1i(uniform.type) : uniform.type == expectedType;
+        if (!matches)
+        {
+#ifndef NDEBUG
+            std::cerr << "ERROR::SHADER::UNIFORM_TYPE_MISMATCH " << uniform.name << std::endl;
+#endif
+            return nullptr;
+        }
+        return &uniform;
+    }
+    return nullptr;
+}
+
+int Shader::GetUniformLocation(uint32_t nameHash) const
+{
+    if (m_UniformSlots.empty())
+        return -1;
+
+    size_t mask = m_UniformSlots.size() - 1;
+    for (size_t slot = nameHash & mask; m_UniformSlots[slot] >= 0; slot = (slot + 1) & mask)
+    {
+        const Uniform& uniform = m_Uniforms[m_UniformSlots[slot]];
+        if (uniform.hash == nameHash)
+            return uniform.location;
+    }
+    return -1;
+}
+
+void Shader::SetInt(uint32_t nameHash, int value) const
+{
+    if (const Uniform* uniform = FindUniform(nameHash, GL_INT))
+        glUniform1i(uniform->location, value);
+}
+
+void Shader::SetFloat(uint32_t nameHash, float value) const
+{
+    if (const Uniform* uniform = FindUniform(nameHash, GL_FLOAT))
+        glUniform1f(uniform->location, value);
+}
+
+void Shader::SetVec2(uint32_t nameHash, float x, float y) const
+{
+    if (const Uniform* uniform = FindUniform(nameHash, GL_FLOAT_VEC2))
+        glUniform2f(uniform->location, x, y);
+}
+
+void Shader::SetVec3(uint32_t nameHash, float x, float y, float z) const
+{
+    if (const Uniform* uniform = FindUniform(nameHash, GL_FLOAT_VEC3))
+        glUniform3f(uniform->location, x, y, z);
+}
+
+void Shader::SetVec3(uint32_t nameHash, const float* value) const
+{
+    if (const Uniform* uniform = FindUniform(nameHash, GL_FLOAT_VEC3))
+        glUniform3fv(uniform->location, 1, value);
+}
+
+void Shader::SetVec4(uint32_t nameHash, float x, float y, float z, float w) const
+{
+    if (const Uniform* uniform = FindUniform(nameHash, GL_FLOAT_VEC4))
+        glUniform4f(uniform->location, x, y, z, w);
+}
+
+void Shader::SetVec4(uint32_t nameHash, const float* value) const
+{
+    if (const Uniform* uniform = FindUniform(nameHash, GL_FLOAT_VEC4))
+        glUniform4fv(uniform->location, 1, value);
+}
+
+void Shader::SetMat4(uint32_t nameHash, const float* columnMajor) const
+{
+    if (const Uniform* uniform = FindUniform(nameHash, GL_FLOAT_MAT4))
+        glUniformMatrix4fv(uniform->location, 1, GL_FALSE, columnMajor);
+}
+
+void Shader::SetMat4(uint32_t nameHash, const Mat4& value) const
+{
+    SetMat4(nameHash, value.Data());
 }
\ No newline at end of file
@@ -0,0 +1,239 @@
+﻿#include "Graphics/ShaderCache.h"
+#include "Core/MappedFile.h"
+#include <glad/glad.h>
+#include "Graphics/GLExtensions.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+// glad只生成了GL 3.3，程序二进制相关的常量和函数自己补上
+#ifndef GL_PROGRAM_BINARY_RETRIEVABLE_HINT
+#define GL_PROGRAM_BINARY_RETRIEVABLE_HINT 0x8257
+#endif
+#ifndef GL_PROGRAM_BINARY_LENGTH
+#define GL_PROGRAM_BINARY_LENGTH 0x8741
+#endif
+#ifndef GL_NUM_PROGRAM_BINARY_FORMATS
+#define GL_NUM_PROGRAM_BINARY_FORMATS 0x87FE
+#endif
+
+typedef void (APIENTRYP PFNGLGETPROGRAMBINARYPROC_CE)(GLuint program, GLsizei bufSize, GLsizei* length, GLenum* binaryFormat, void* binary);
+typedef void (APIENTRYP PFNGLPROGRAMBINARYPROC_CE)(GLuint program, GLenum binaryFormat, const void* binary, GLsizei length);
+typedef void (APIENTRYP PFNGLPROGRAMPARAMETERIPROC_CE)(GLuint program, GLenum pname, GLint value);
+
+static PFNGLGETPROGRAMBINARYPROC_CE s_GetProgramBinary = nullptr;
+static PFNGLPROGRAMBINARYPROC_CE s_ProgramBinary = nullptr;
+static PFNGLPROGRAMPARAMETERIPROC_CE s_ProgramParameteri = nullptr;
+
+const uint32_t ShaderCacheMagic = 0x42504C47;  // "GLPB"
+const uint32_t ShaderCacheVersion = 1;
+
+struct ShaderCacheHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint64_t key;
+    uint32_t binaryFormat;
+    uint32_t binarySize;
+    double compileMilliseconds;    // 写入时从源码编译的耗时
+};
+static_assert(sizeof(ShaderCacheHeader) == 32, "ShaderCacheHeader布局变化时需要提升ShaderCacheVersion");
+
+static double NowMilliseconds()
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// 64位FNV-1a，字符串之间用'\0'分隔，避免"ab"+"c"和"a"+"bc"得到同样的键
+static uint64_t HashBytes(uint64_t hash, const char* str)
+{
+    for (const char* p = str; ; ++p)
+    {
+        hash = (hash ^ static_cast<uint8_t>(*p)) * 1099511628211ull;
+        if (*p == '\0')
+            break;
+    }
+    return hash;
+}
+
+ShaderCache::ShaderCache(const std::string& directory)
+    : m_Directory(directory), m_Supported(false),
+    m_HitCount(0), m_MissCount(0), m_RejectCount(0),
+    m_LoadMilliseconds(0.0), m_CompileMilliseconds(0.0), m_SavedMilliseconds(0.0)
+{
+}
+
+bool ShaderCache::Initialize()
+{
+    const char* vendor = reinterpret_cast<const char*>(glGetString(GL_VENDOR));
+    const char* renderer = reinterpret_cast<const char*>(glGetString(GL_RENDERER));
+    const char* version = reinterpret_cast<const char*>(glGetString(GL_VERSION));
+    m_DriverInfo = std::string(vendor ? vendor : "") + "\n" + (renderer ? renderer : "") + "\n" + (version ? version : "");
+
+    GLint major = 0, minor = 0;
+    glGetIntegerv(GL_MAJOR_VERSION, &major);
+    glGetIntegerv(GL_MINOR_VERSION, &minor);
+    bool core41 = major > 4 || (major == 4 && minor >= 1);
+    if (!core41 && !IsGLExtensionSupported("GL_ARB_get_program_binary"))
+        return false;
+
+    s_GetProgramBinary = reinterpret_cast<PFNGLGETPROGRAMBINARYPROC_CE>(GetGLProcAddress("glGetProgramBinary"));
+    s_ProgramBinary = reinterpret_cast<PFNGLPROGRAMBINARYPROC_CE>(GetGLProcAddress("glProgramBinary"));
+    s_ProgramParameteri = reinterpret_cast<PFNGLPROGRAMPARAMETERIPROC_CE>(GetGLProcAddress("glProgramParameteri"));
+    if (!s_GetProgramBinary || !s_ProgramBinary || !s_ProgramParameteri)
+        return false;
+
+    // 支持扩展但一种二进制格式都没有时，存了也加载不回来
+    GLint formatCount = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount);
+    if (formatCount <= 0)
+        return false;
+
+    std::error_code ec;
+    std::filesystem::create_directories(m_Directory, ec);
+    if (ec)
+    {
+        std::cerr << "无法创建着色器缓存目录: " << m_Directory << std::endl;
+        return false;
+    }
+
+    m_Supported = true;
+    return true;
+}
+
+uint64_t ShaderCache::ComputeKey(const char* vertexSource, const char* fragmentSource) const
+{
+    uint64_t hash = 14695981039346656037ull;
+    hash = HashBytes(hash, vertexSource);
+    hash = HashBytes(hash, fragmentSource);
+    hash = HashBytes(hash, m_DriverInfo.c_str());
+    return hash;
+}
+
+std::string ShaderCache::GetPath(uint64_t key) const
+{
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.glbin", static_cast<unsigned long long>(key));
+    return (std::filesystem::path(m_Directory) / name).string();
+}
+
+unsigned int ShaderCache::LoadProgram(uint64_t key)
+{
+    if (!m_Supported)
+    {
+        ++m_MissCount;
+        return 0;
+    }
+
+    double start = NowMilliseconds();
+    std::string path = GetPath(key);
+
+    MappedFile file;
+    if (!file.Open(path))
+    {
+        ++m_MissCount;
+        return 0;
+    }
+
+    const ShaderCacheHeader* header = reinterpret_cast<const ShaderCacheHeader*>(file.GetData());
+    if (file.GetSize() < sizeof(ShaderCacheHeader) || header->magic != ShaderCacheMagic ||
+        header->version != ShaderCacheVersion || header->key != key ||
+        file.GetSize() - sizeof(ShaderCacheHeader) < header->binarySize)
+    {
+        std::cerr << "警告：着色器缓存文件无效，重新编译: " << path << std::endl;
+        file.Close();
+        std::error_code ec;
+        std::filesystem::remove(path, ec);
+        ++m_MissCount;
+        return 0;
+    }
+
+    GLuint program = glCreateProgram();
+    s_ProgramBinary(program, header->binaryFormat, file.GetData() + sizeof(ShaderCacheHeader), static_cast<GLsizei>(header->binarySize));
+    GLint success = 0;
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
+    double compileMilliseconds = header->compileMilliseconds;
+    file.Close();
+
+    if (!success)
+    {
+        // 驱动版本字符串没变但内部格式变了等情况：删掉，让调用方重新编译后覆盖
+        glDeleteProgram(program);
+        std::error_code ec;
+        std::filesystem::remove(path, ec);
+        ++m_RejectCount;
+        ++m_MissCount;
+        return 0;
+    }
+
+    double elapsed = NowMilliseconds() - start;
+    ++m_HitCount;
+    m_LoadMilliseconds += elapsed;
+    m_SavedMilliseconds += compileMilliseconds - elapsed;
+    return program;
+}
+
+void ShaderCache::PrepareProgram(unsigned int program) const
+{
+    if (m_Supported)
+        s_ProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+}
+
+bool ShaderCache::StoreProgram(uint64_t key, unsigned int program, double compileMilliseconds)
+{
+    m_CompileMilliseconds += compileMilliseconds;
+    if (!m_Supported)
+        return false;
+
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0)
+        return false;
+
+    std::vector<char> binary(static_cast<size_t>(length));
+    GLsizei written = 0;
+    GLenum format = 0;
+    s_GetProgramBinary(program, length, &written, &format, binary.data());
+    if (written <= 0)
+        return false;
+
+    ShaderCacheHeader header;
+    std::memset(&header, 0, sizeof(header));
+    header.magic = ShaderCacheMagic;
+    header.version = ShaderCacheVersion;
+    header.key = key;
+    header.binaryFormat = format;
+    header.binarySize = static_cast<uint32_t>(written);
+    header.compileMilliseconds = compileMilliseconds;
+
+    // 先写临时文件再重命名，同时启动的另一个进程不会读到写了一半的文件
+    std::string path = GetPath(key);
+    std::string tempPath = path + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open())
+            return false;
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(binary.data(), written);
+        if (!file.good())
+        {
+            file.close();
+            std::error_code ec;
+            std::filesystem::remove(tempPath, ec);
+            return false;
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(tempPath, path, ec);
+    if (ec)
+    {
+        std::filesystem::remove(tempPath, ec);
+        return false;
+    }
+    return true;
+}
\ No newline at end of file
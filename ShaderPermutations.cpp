@@ -0,0 +1,111 @@
+﻿#include "Graphics/ShaderPermutations.h"
+#include <iostream>
+
+ShaderPermutationSet::ShaderPermutationSet(const char* vertexSource, const char* fragmentSource,
+    const std::vector<std::string>& features, ShaderCache* cache)
+    : m_VertexSource(vertexSource), m_FragmentSource(fragmentSource), m_Features(features), m_Cache(cache), m_FailedCount(0)
+{
+    if (m_Features.size() > 32)
+    {
+        std::cerr << "着色器变体开关超过32个，多出的开关被忽略" << std::endl;
+        m_Features.resize(32);
+    }
+}
+
+uint32_t ShaderPermutationSet::GetFeatureBit(const char* feature) const
+{
+    for (size_t i = 0; i < m_Features.size(); ++i)
+    {
+        if (m_Features[i] == feature)
+            return 1u << i;
+    }
+    return 0;
+}
+
+std::string ShaderPermutationSet::BuildSource(const std::string& source, uint32_t mask) const
+{
+    std::string defines;
+    for (size_t i = 0; i < m_Features.size(); ++i)
+    {
+        if (mask & (1u << i))
+            defines += "#define " + m_Features[i] + " 1\n";
+    }
+    if (defines.empty())
+        return source;
+
+    // #version必须是第一条指令，define插在它的下一行；没有#version时插在最前面
+    size_t insert = 0;
+    size_t version = source.find("#version");
+    if (version != std::string::npos)
+    {
+        size_t lineEnd = source.find('\n', version);
+        insert = (lineEnd == std::string::npos) ? source.size() : lineEnd + 1;
+    }
+    std::string result = source.substr(0, insert);
+    if (insert > 0 && result.back() != '\n')
+        result += '\n';
+    result += defines;
+    result.append(source, insert, std::string::npos);
+    return result;
+}
+
+void ShaderPermutationSet::Create(uint32_t mask)
+{
+    std::string vertexSource = BuildSource(m_VertexSource, mask);
+    std::string fragmentSource = BuildSource(m_FragmentSource, mask);
+
+    Variant& variant = m_Variants[mask];
+    variant.shader.reset(new Shader(vertexSource.c_str(), fragmentSource.c_str(), m_Cache, Shader::CompileMode::Deferred));
+    variant.pending = true;
+}
+
+void ShaderPermutationSet::Prewarm(uint32_t mask)
+{
+    if (m_Variants.find(mask) == m_Variants.end())
+        Create(mask);
+}
+
+Shader* ShaderPermutationSet::Get(uint32_t mask)
+{
+    return Resolve(mask, false);
+}
+
+Shader* ShaderPermutationSet::Require(uint32_t mask)
+{
+    return Resolve(mask, true);
+}
+
+Shader* ShaderPermutationSet::Resolve(uint32_t mask, bool wait)
+{
+    std::unordered_map<uint32_t, Variant>::iterator it = m_Variants.find(mask);
+    if (it == m_Variants.end())
+    {
+        Create(mask);
+        it = m_Variants.find(mask);
+    }
+
+    Variant& variant = it->second;
+    Shader* shader = variant.shader.get();
+    if (variant.pending)
+    {
+        if (wait)
+            shader->Finish();
+        else if (!shader->IsReady())
+            return nullptr;
+        variant.pending = false;
+        if (!shader->IsValid())
+            ++m_FailedCount;
+    }
+    return shader->IsValid() ? shader : nullptr;
+}
+
+size_t ShaderPermutationSet::GetPendingCount() const
+{
+    size_t count = 0;
+    for (const std::pair<const uint32_t, Variant>& entry : m_Variants)
+    {
+        if (entry.second.pending)
+            ++count;
+    }
+    return count;
+}
\ No newline at end of file
@@ -0,0 +1,230 @@
+﻿#include "Graphics/StreamBuffer.h"
+#include <glad/glad.h>
+#include "Graphics/GLExtensions.h"
+#include "Graphics/GLStateCache.h"
+#include <chrono>
+#include <iostream>
+
+// glad只生成了GL 3.3，持久映射相关的常量和函数自己补上
+#ifndef GL_MAP_PERSISTENT_BIT
+#define GL_MAP_PERSISTENT_BIT 0x0040
+#endif
+#ifndef GL_MAP_COHERENT_BIT
+#define GL_MAP_COHERENT_BIT 0x0080
+#endif
+
+// 映射、orphan等操作都绑定到GL_COPY_WRITE_BUFFER上做，不影响当前VAO记录的GL_ELEMENT_ARRAY_BUFFER
+static const GLenum BufferTarget = GL_COPY_WRITE_BUFFER;
+
+typedef void (APIENTRYP PFNGLBUFFERSTORAGEPROC_CE)(GLenum target, GLsizeiptr size, const void* data, GLbitfield flags);
+
+// GL 4.4或者有ARB_buffer_storage扩展时返回glBufferStorage，否则返回nullptr
+static PFNGLBUFFERSTORAGEPROC_CE LoadBufferStorage()
+{
+    GLint major = 0, minor = 0;
+    glGetIntegerv(GL_MAJOR_VERSION, &major);
+    glGetIntegerv(GL_MINOR_VERSION, &minor);
+    bool core44 = major > 4 || (major == 4 && minor >= 4);
+    if (!core44 && !IsGLExtensionSupported("GL_ARB_buffer_storage"))
+        return nullptr;
+    return reinterpret_cast<PFNGLBUFFERSTORAGEPROC_CE>(GetGLProcAddress("glBufferStorage"));
+}
+
+StreamBuffer::StreamBuffer()
+    : m_Buffer(0), m_RegionSize(0), m_RegionCount(0), m_CurrentRegion(0), m_RegionUsed(0),
+    m_Persistent(false), m_PersistentData(nullptr), m_RegionData(nullptr),
+    m_WaitCount(0), m_WaitMilliseconds(0.0), m_OrphanCount(0)
+{
+    for (int i = 0; i < MaxRegions; ++i)
+        m_Fences[i] = nullptr;
+}
+
+StreamBuffer::~StreamBuffer()
+{
+    Destroy();
+}
+
+bool StreamBuffer::Create(size_t regionSize, int regionCount)
+{
+    Destroy();
+    if (regionCount < 2 || regionCount > MaxRegions)
+    {
+        std::cerr << "StreamBuffer段数必须在2到" << MaxRegions << "之间: " << regionCount << std::endl;
+        return false;
+    }
+
+    m_RegionSize = regionSize > 0 ? regionSize : 1;
+    m_RegionCount = regionCount;
+    m_CurrentRegion = regionCount - 1;  // 第一次BeginFrame切到第0段
+    m_RegionUsed = 0;
+
+    GLsizeiptr totalSize = static_cast<GLsizeiptr>(m_RegionSize * m_RegionCount);
+    glGenBuffers(1, &m_Buffer);
+    GetGLStateCache().BindBuffer(BufferTarget, m_Buffer);
+
+    // 1. 优先用持久映射：分配不可变存储，映射一次
+    PFNGLBUFFERSTORAGEPROC_CE bufferStorage = LoadBufferStorage();
+    if (bufferStorage)
+    {
+        GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        bufferStorage(BufferTarget, totalSize, nullptr, flags);
+        m_PersistentData = static_cast<unsigned char*>(glMapBufferRange(BufferTarget, 0, totalSize, flags));
+        if (m_PersistentData)
+        {
+            m_Persistent = true;
+            return true;
+        }
+
+        // 映射失败时换一个普通缓冲对象，不可变存储不能再用glBufferData
+        std::cerr << "StreamBuffer持久映射失败，改用非同步映射" << std::endl;
+        GetGLStateCache().DeleteBuffer(m_Buffer);
+        glGenBuffers(1, &m_Buffer);
+        GetGLStateCache().BindBuffer(BufferTarget, m_Buffer);
+    }
+
+    // 2. GL 3.3：普通可变存储，每帧映射当前段
+    glBufferData(BufferTarget, totalSize, nullptr, GL_STREAM_DRAW);
+    m_Persistent = false;
+    return true;
+}
+
+void StreamBuffer::Destroy()
+{
+    if (m_Buffer == 0)
+        return;
+
+    for (int i = 0; i < MaxRegions; ++i)
+    {
+        if (m_Fences[i])
+        {
+            glDeleteSync(static_cast<GLsync>(m_Fences[i]));
+            m_Fences[i] = nullptr;
+        }
+    }
+
+    GetGLStateCache().BindBuffer(BufferTarget, m_Buffer);
+    if (m_PersistentData || m_RegionData)
+        glUnmapBuffer(BufferTarget);
+    GetGLStateCache().DeleteBuffer(m_Buffer);
+
+    m_Buffer = 0;
+    m_PersistentData = nullptr;
+    m_RegionData = nullptr;
+    m_Persistent = false;
+}
+
+void StreamBuffer::WaitForRegion(int region)
+{
+    GLsync fence = static_cast<GLsync>(m_Fences[region]);
+    if (!fence)
+        return;
+
+    // 先不等待地查询一次，已经signaled时不计入等待
+    GLenum result = glClientWaitSync(fence, 0, 0);
+    if (result == GL_TIMEOUT_EXPIRED)
+    {
+        auto start = std::chrono::steady_clock::now();
+        do
+        {
+            // 第一次等待时刷新命令队列，否则fence可能永远不会被执行到
+            result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);  // 1ms
+        } while (result == GL_TIMEOUT_EXPIRED);
+        m_WaitCount++;
+        m_WaitMilliseconds += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+    if (result == GL_WAIT_FAILED)
+        std::cerr << "StreamBuffer等待fence失败" << std::endl;
+
+    glDeleteSync(fence);
+    m_Fences[region] = nullptr;
+}
+
+void StreamBuffer::BeginFrame()
+{
+    if (m_Buffer == 0)
+        return;
+
+    m_CurrentRegion = (m_CurrentRegion + 1) % m_RegionCount;
+    m_RegionUsed = 0;
+    size_t regionOffset = m_RegionSize * m_CurrentRegion;
+
+    if (m_Persistent)
+    {
+        // 持久映射只能等GPU读完这一段
+        WaitForRegion(m_CurrentRegion);
+        m_RegionData = m_PersistentData + regionOffset;
+        return;
+    }
+
+    GetGLStateCache().BindBuffer(BufferTarget, m_Buffer);
+
+    // 这一段还在被GPU使用：orphan整块缓冲，驱动为之后的命令分配新存储，旧存储等GPU用完再释放
+    // 新存储上没有任何未完成的读取，所有fence都可以丢掉
+    GLsync fence = static_cast<GLsync>(m_Fences[m_CurrentRegion]);
+    if (fence && glClientWaitSync(fence, 0, 0) == GL_TIMEOUT_EXPIRED)
+    {
+        glBufferData(BufferTarget, static_cast<GLsizeiptr>(m_RegionSize * m_RegionCount), nullptr, GL_STREAM_DRAW);
+        for (int i = 0; i < m_RegionCount; ++i)
+        {
+            if (m_Fences[i])
+            {
+                glDeleteSync(static_cast<GLsync>(m_Fences[i]));
+                m_Fences[i] = nullptr;
+            }
+        }
+        m_OrphanCount++;
+    }
+    else if (fence)
+    {
+        glDeleteSync(fence);
+        m_Fences[m_CurrentRegion] = nullptr;
+    }
+
+    // fence保证了这一段没有未完成的读取，映射时不需要驱动再同步
+    GLbitfield access = GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_INVALIDATE_RANGE_BIT;
+    m_RegionData = static_cast<unsigned char*>(glMapBufferRange(BufferTarget, static_cast<GLintptr>(regionOffset),
+        static_cast<GLsizeiptr>(m_RegionSize), access));
+    if (!m_RegionData)
+        std::cerr << "StreamBuffer映射失败" << std::endl;
+}
+
+StreamBuffer::Allocation StreamBuffer::Allocate(size_t size, size_t alignment)
+{
+    Allocation allocation = { nullptr, 0, size };
+    if (!m_RegionData)
+        return allocation;
+
+    // 按缓冲内的绝对偏移对齐，offset直接用作属性/索引偏移
+    size_t regionOffset = m_RegionSize * m_CurrentRegion;
+    size_t absolute = regionOffset + m_RegionUsed;
+    if (alignment > 1)
+        absolute = (absolute + alignment - 1) / alignment * alignment;
+    size_t used = absolute - regionOffset;
+    if (used + size > m_RegionSize)
+        return allocation;
+
+    allocation.data = m_RegionData + used;
+    allocation.offset = absolute;
+    m_RegionUsed = used + size;
+    return allocation;
+}
+
+void StreamBuffer::Commit()
+{
+    if (m_Persistent || !m_RegionData)
+        return;
+
+    GetGLStateCache().BindBuffer(BufferTarget, m_Buffer);
+    glUnmapBuffer(BufferTarget);
+    m_RegionData = nullptr;
+}
+
+void StreamBuffer::EndFrame()
+{
+    if (m_Buffer == 0)
+        return;
+
+    if (m_Fences[m_CurrentRegion])
+        glDeleteSync(static_cast<GLsync>(m_Fences[m_CurrentRegion]));
+    m_Fences[m_CurrentRegion] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
\ No newline at end of file
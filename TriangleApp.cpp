@@ -2,25 +2,49 @@
 #include <glad/glad.h>
 #include <iostream>
 #include <cmath>
+#include <cstring>
+#include <cassert>
 #include "imgui.h"
-#include "Vector3.h"
+#include "BackFaceCulling.h"
+#include "Core/CpuFeatures.h"
+#include "Core/JobSystem.h"
+#include "Core/FrameAllocator.h"
+#include "Graphics/ShaderCache.h"
+#include "Graphics/ShaderPermutations.h"
+#include "Graphics/GLStateCache.h"
+#include "Graphics/RenderCommandList.h"
+#include "Core/FramePacer.h"
+#include "Core/RenderThread.h"
+#include "Core/Profiler.h"
+#include <chrono>
 
 #define PI 3.1415926535897
 
 const char* vertexShaderSource = R"(
     #version 330 core
     layout (location = 0) in vec3 aPos;
-    
+
+    // ģʽӳפģ궥㻺㣬ģͱ任
+    uniform mat4 uModel;
+    uniform mat4 uView;
+    uniform mat4 uProjection;
+
     out float vZCoord;
+    out vec3 vWorldPos;
 
     void main()
     {
-        gl_Position = vec4(aPos * 0.2, 1.0);
+        vec4 worldPos = uModel * vec4(aPos, 1.0);
+        gl_Position = uProjection * uView * worldPos;
         vZCoord = gl_Position.z;
+        vWorldPos = worldPos.xyz;
     }
     )";
 
 
+// 忪أShaderPermutationSet#versionע#define
+//   DEPTH_FADE    򱳾ɫ
+//   FLAT_SHADING  Ļռ䵼淨ߣ򵥵ƽ
 const char* fragmentShaderSource = R"(
     #version 330 core
     out vec4 FragColor;
@@ -28,20 +52,62 @@ const char* fragmentShaderSource = R"(
     uniform vec3 uObjectColor;
     uniform vec3 uBackgroundColor;
     in float vZCoord;
+    in vec3 vWorldPos;
 
     void main()
     {
+        vec3 finalColor = uObjectColor;
+    #ifdef FLAT_SHADING
+        vec3 normal = normalize(cross(dFdx(vWorldPos), dFdy(vWorldPos)));
+        finalColor *= 0.3 + 0.7 * abs(normal.z);
+    #endif
+    #ifdef DEPTH_FADE
         //float normalizedZ = (vZCoord+1) * 0.5;
         float normalizedZ = (vZCoord+1) * 1;
-        vec3 finalColor = mix(uObjectColor, uBackgroundColor, normalizedZ);
+        finalColor = mix(finalColor, uBackgroundColor, normalizedZ);
+    #endif
         FragColor = vec4(finalColor, 1.0);
     }
     )";
 
+// uniformֵĹϣڱãRenderﰴϣ
+static constexpr uint32_t kObjectColor = HashString("uObjectColor");
+static constexpr uint32_t kBackgroundColor = HashString("uBackgroundColor");
+static constexpr uint32_t kModel = HashString("uModel");
+static constexpr uint32_t kView = HashString("uView");
+static constexpr uint32_t kProjection = HashString("uProjection");
+
 TriangleApp::TriangleApp()
     : Application("Triangle Engine", 800, 800),
-    m_VAO(0), m_VBO(0), m_ShaderProgram(0)
+    m_VAO(0), m_ActiveShader(nullptr), m_ShaderFeatures(0),
+    m_StaticVAO(0), m_StaticVBO(0), m_StaticEBO(0), m_UseGpuTransform(false), m_ModelYaw(0.0f),
+    m_SpinSpeed(0.0f), m_SpinYaw(0.0), m_PreviousSpinYaw(0.0),
+    m_IndexType(GL_UNSIGNED_INT), m_RenderIndexCount(0), m_RenderIndexOffset(0),
+    m_StreamedThisFrame(false), m_UploadBytes(0),
+    m_UploadVAO(0), m_UploadEBO(0), m_UploadCapacity(0), m_UploadThroughCommands(false), m_UseParallelCull(true), m_CullMilliseconds(0.0),
+    m_TransformCacheValid(false), m_CachedModelVersion(0),
+    m_CacheHits(0), m_CacheMisses(0), m_SkippedVertices(0), m_SkippedTriangles(0), m_SkippedUploadBytes(0), m_CachedUploadBytes(0)
 {
+    //  x  45 +  y  45 ϲת
+    const float rotationMatrix[16] = {
+        0.70710678f,  0.5f,          0.5f,          0.0f,
+        0.0f,         0.70710678f,  -0.70710678f,  0.0f,
+        -0.70710678f, 0.5f,          0.5f,          0.0f,
+        0.0f,         0.0f,          0.0f,          1.0f
+    };
+    m_BaseRotation = Mat4(rotationMatrix);
+    m_ModelMatrix.Set(m_BaseRotation);
+
+    // û۲ΪλͶӰֻģС0.2
+    const float projectionMatrix[16] = {
+        0.2f, 0.0f, 0.0f, 0.0f,
+        0.0f, 0.2f, 0.0f, 0.0f,
+        0.0f, 0.0f, 0.2f, 0.0f,
+        0.0f, 0.0f, 0.0f, 1.0f
+    };
+    m_ViewMatrix = Mat4::Identity();
+    m_ProjectionMatrix = Mat4(projectionMatrix);
+
     // ʼImGuiƱ
     m_ClearColor[0] = 0.2f;  // R
     m_ClearColor[1] = 0.3f;  // G
@@ -58,48 +124,175 @@ TriangleApp::TriangleApp()
 
     m_ShowDemoWindow = false;
     m_ShowControlWindow = true;
+    m_ShowProfiler = false;
+
+    // ֻ޳״̬ͬʼuniformɫ۲ͶӰͬ
+    m_CulledMaterial.depthTest = true;
+    m_CulledMaterial.cullFace = true;
+    m_CulledMaterial.frontFace = GL_CW;
+    m_CulledMaterial.cullMode = GL_BACK;
+    m_CulledMaterial.setUniforms = &TriangleApp::SetMaterialUniforms;
+    m_CulledMaterial.context = this;
+    m_PreCulledMaterial = m_CulledMaterial;
+    m_PreCulledMaterial.cullFace = false;
+
+    std::memset(&m_RenderStats, 0, sizeof(m_RenderStats));
 }
 
 void TriangleApp::Initialize() {
-    SetupShaders();
+    // ֻеһ֡Ҫõıȴɣڿƴһιѡʱű
+    std::vector<std::string> features = { "DEPTH_FADE", "FLAT_SHADING" };
+    m_Shaders.reset(new ShaderPermutationSet(vertexShaderSource, fragmentShaderSource, features, &GetShaderCache()));
+    m_ShaderFeatures = m_Shaders->GetFeatureBit("DEPTH_FADE");
+    m_ActiveShader = m_Shaders->Require(m_ShaderFeatures);
     SetupBuffers();
 }
 
 void TriangleApp::Render()
 {
     // 1. ñɫ
-    glClearColor(m_ClearColor[0], m_ClearColor[1], m_ClearColor[2], m_ClearColor[3]);
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    ClearCommand clear;
+    std::memcpy(clear.color, m_ClearColor, sizeof(clear.color));
+    GetRenderCommands().Record(&TriangleApp::ClearTarget, clear);
+
+    // 2. ѡеı廹ں̨ʱһõı
+    // ѯ״̬ҪGLģȾ߳ģʽ¼Ƴһ֡
+    ShaderRequest request = { this, m_ShaderFeatures };
+    if (IsRenderThreadEnabled()) {
+        GetRenderCommands().Record(&TriangleApp::ResolveShader, request);
+    }
+    else {
+        ResolveShader(&request);
+    }
+    Shader* shader = m_ActiveShader.load();
+    if (!shader) {
+        return;
+    }
+
+    // 3. ύưRenderغɻƶ״̬
+    // ޳CPUģʽѾ޳ò޳ĲʣGPUģʽդ
+    // CPU޳(b - a) x (c - a)zС0ΣĻ˳ʱ
+    DrawPacket packet;
+    packet.shader = shader;
+    packet.primitive = GL_TRIANGLES;
+    packet.indexType = m_IndexType;
+    packet.setUniforms = &TriangleApp::SetDrawUniforms;
+    if (m_UseGpuTransform) {
+        packet.material = &m_CulledMaterial;
+        packet.vertexArray = m_StaticVAO;
+        packet.indexCount = static_cast<int>(allMeshIndices.size());
+        packet.indexOffset = 0;
+    }
+    else if (m_TransformCacheValid) {
+        // Գפľ̬㻺壬ֻпɼεʽ壨Ⱦ߳ģʽµϴ壩
+        // ʱ֡ûдֱٻһϴдһ
+        packet.material = &m_PreCulledMaterial;
+        packet.vertexArray = m_UploadThroughCommands ? m_UploadVAO : m_VAO;
+        packet.indexCount = m_RenderIndexCount;
+        packet.indexOffset = m_RenderIndexOffset;
+    }
+    else {
+        return;
+    }
 
-    //Ȳ
-    glEnable(GL_DEPTH_TEST);
+    // ģ;Ƶ֡طʱ߳̿Ѿڸһ֡ľ
+    Mat4* model = GetFrameAllocator().AllocateArray<Mat4>(1);
+    *model = m_ModelMatrix.Get();
+    packet.context = model;
 
-    // 2. ɫ
-    glUseProgram(m_ShaderProgram);
+    // ȡģԭڹ۲ռеľ루۲췽Ϊ-z
+    Vector3 center = (m_ViewMatrix * *model).TransformPoint(Vector3(0.0f, 0.0f, 0.0f));
+    uint64_t key = RenderQueue::MakeSortKey(RenderPass::Opaque, shader->GetID(), packet.material == &m_CulledMaterial ? 1 : 2,
+        packet.vertexArray, -center.z);
+    GetRenderQueue().Submit(key, packet);
+}
 
-    // ɫɫ
-    int objectColorLoc = glGetUniformLocation(m_ShaderProgram, "uObjectColor");
-    glUniform3f(objectColorLoc, 1.0f, 1.0f, 1.0f);  // ɫ޸ΪǺɫ
+void TriangleApp::ClearTarget(const void* data)
+{
+    const ClearCommand* clear = static_cast<const ClearCommand*>(data);
+    glClearColor(clear->color[0], clear->color[1], clear->color[2], clear->color[3]);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+}
 
-    // Ƚɫ Uniformȱʧĸֵ
-    int bgColorLoc = glGetUniformLocation(m_ShaderProgram, "uBackgroundColor");
-    if (bgColorLoc != -1) {
-        glUniform3f(bgColorLoc, 0.0f, 0.0f, 0.0f);
+void TriangleApp::ResolveShader(const void* data)
+{
+    const ShaderRequest* request = static_cast<const ShaderRequest*>(data);
+    Shader* shader = request->app->m_Shaders->Get(request->features);
+    if (shader) {
+        request->app->m_ActiveShader.store(shader);
     }
+}
+
+void TriangleApp::UploadIndices(const void* data)
+{
+    // orphanͷдһ֡Ļƻõľɴ洢
+    PROFILE_ZONE("UploadIndices");
+    const UploadCommand* upload = static_cast<const UploadCommand*>(data);
+    GetGLStateCache().BindBuffer(GL_COPY_WRITE_BUFFER, upload->app->m_UploadEBO);
+    glBufferData(GL_COPY_WRITE_BUFFER, upload->app->m_UploadCapacity, nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_COPY_WRITE_BUFFER, 0, upload->bytes, upload->indices);
+}
 
-    // 5. 
-    glBindVertexArray(m_VAO);
-    int vertexCount = renderVerticals.size() / 3;
-    glDrawArrays(GL_TRIANGLES, 0, vertexCount);
+void TriangleApp::EndIndexStreamFrame(const void* data)
+{
+    (*static_cast<TriangleApp* const*>(data))->m_IndexStream.EndFrame();
+}
+
+void TriangleApp::CaptureRenderStats(const void* data)
+{
+    TriangleApp* app = *static_cast<TriangleApp* const*>(data);
+    RenderStats stats;
+    stats.variantCount = app->m_Shaders->GetVariantCount();
+    stats.pendingVariants = app->m_Shaders->GetPendingCount();
+    stats.failedVariants = app->m_Shaders->GetFailedCount();
+    const ShaderCache& shaderCache = app->GetShaderCache();
+    stats.shaderCacheSupported = shaderCache.IsSupported();
+    stats.shaderCacheHits = shaderCache.GetHitCount();
+    stats.shaderCacheMisses = shaderCache.GetMissCount();
+    stats.shaderCacheRejects = shaderCache.GetRejectCount();
+    stats.shaderCacheSavedMilliseconds = shaderCache.GetSavedMilliseconds();
+    stats.streamPersistent = app->m_IndexStream.IsPersistent();
+    stats.streamWaits = app->m_IndexStream.GetWaitCount();
+    stats.streamWaitMilliseconds = app->m_IndexStream.GetWaitMilliseconds();
+    stats.streamOrphans = app->m_IndexStream.GetOrphanCount();
+    const GLStateCache& glState = GetGLStateCache();
+    stats.glIssued = glState.GetIssuedCount();
+    stats.glRedundant = glState.GetRedundantCount();
+    stats.glValidating = glState.IsValidationEnabled();
+
+    std::lock_guard<std::mutex> lock(app->m_RenderStatsMutex);
+    app->m_RenderStats = stats;
+}
+
+void TriangleApp::SetMaterialUniforms(Shader& shader, const void* context)
+{
+    const TriangleApp* app = static_cast<const TriangleApp*>(context);
+    shader.SetVec3(kObjectColor, 1.0f, 1.0f, 1.0f);
+    shader.SetVec3(kBackgroundColor, 0.0f, 0.0f, 0.0f);
+    shader.SetMat4(kView, app->m_ViewMatrix);
+    shader.SetMat4(kProjection, app->m_ProjectionMatrix);
+}
+
+void TriangleApp::SetDrawUniforms(Shader& shader, const void* context)
+{
+    // ģʽɫģͱ任CPUģʽֻCPUϱ任һ޳
+    shader.SetMat4(kModel, *static_cast<const Mat4*>(context));
 }
 
 void TriangleApp::Shutdown() {
     std::cout << "Shutting down Triangle App..." << std::endl;
 
     // Դ
-    glDeleteVertexArrays(1, &m_VAO);
-    glDeleteBuffers(1, &m_VBO);
-    glDeleteProgram(m_ShaderProgram);
+    GLStateCache& state = GetGLStateCache();
+    state.DeleteVertexArray(m_VAO);
+    m_IndexStream.Destroy();
+    state.DeleteVertexArray(m_StaticVAO);
+    state.DeleteBuffer(m_StaticVBO);
+    state.DeleteBuffer(m_StaticEBO);
+    state.DeleteVertexArray(m_UploadVAO);
+    state.DeleteBuffer(m_UploadEBO);
+    m_ActiveShader = nullptr;
+    m_Shaders.reset();
 }
 
 void TriangleApp::OnImGuiRender()
@@ -110,6 +303,9 @@ void TriangleApp::OnImGuiRender()
         ImGui::ShowDemoWindow(&m_ShowDemoWindow);
     }
 
+    // ʱĻͼ
+    m_ProfilerWindow.Draw(&m_ShowProfiler);
+
     // 2. ƴ
     if (m_ShowControlWindow)
     {
@@ -130,135 +326,343 @@ void TriangleApp::OnImGuiRender()
         ImGui::Checkbox("Show Demo Window", &m_ShowDemoWindow);
         ImGui::Separator();
 
-        // 2.4 Ϣ
+        // 2.4 任CPUGPU
+        ImGui::Text("Vertex Transform:");
+        ImGui::SameLine();
+        if (ImGui::RadioButton("CPU", !m_UseGpuTransform)) m_UseGpuTransform = false;
+        ImGui::SameLine();
+        if (ImGui::RadioButton("GPU", m_UseGpuTransform)) m_UseGpuTransform = true;
+        ImGui::Text("Upload per frame: %.1f KB", m_UploadBytes / 1024.0);
+        if (ImGui::Checkbox("Multithreaded CPU path", &m_UseParallelCull)) InvalidateTransformCache();
+        ImGui::SameLine();
+        ImGui::Text("%u threads, transform + cull %.3f ms", GetJobSystem().GetThreadCount(), m_CullMilliseconds);
+        ImGui::Text("Heap allocations last frame: %zu (%zu bytes), frame arena peak %.1f KB",
+            GetFrameAllocationCount(), GetFrameAllocatedBytes(), GetFrameAllocator().Current().GetPeak() / 1024.0);
+        ImGui::SliderFloat("Model Yaw", &m_ModelYaw, -180.0f, 180.0f, "%.1f deg");
+        ImGui::SliderFloat("Spin Speed", &m_SpinSpeed, -180.0f, 180.0f, "%.1f deg/s");
+
+        // ̶ģ⣺رʱÿ֡ʵ֡ʱģһ
+        bool fixedStep = GetFixedTimestep() > 0.0;
+        float simulationRate = fixedStep ? static_cast<float>(1.0 / GetFixedTimestep()) : 60.0f;
+        if (ImGui::Checkbox("Fixed timestep", &fixedStep)) {
+            SetFixedTimestep(fixedStep ? 1.0 / simulationRate : 0.0, GetMaxStepsPerFrame());
+        }
+        if (fixedStep) {
+            ImGui::SameLine();
+            if (ImGui::SliderFloat("Simulation Hz", &simulationRate, 10.0f, 240.0f, "%.0f")) {
+                SetFixedTimestep(1.0 / simulationRate, GetMaxStepsPerFrame());
+            }
+        }
+        ImGui::Text("Simulation: %d steps last frame, alpha %.2f, time %.2f s, dropped %.3f s",
+            GetStepsLastFrame(), GetInterpolationAlpha(), GetSimulationTime(), GetDroppedSimulationTime());
+        size_t cacheLookups = m_CacheHits + m_CacheMisses;
+        ImGui::Text("Transform cache: %.1f%% hit (%zu hits, %zu recomputes)",
+            cacheLookups ? 100.0 * m_CacheHits / cacheLookups : 0.0, m_CacheHits, m_CacheMisses);
+        ImGui::Text("Skipped: %zu vertices, %zu triangles, %.1f MB upload",
+            m_SkippedVertices, m_SkippedTriangles, m_SkippedUploadBytes / (1024.0 * 1024.0));
+        // ɫ塢ɫ桢ʽGL״̬ڳĵ߳ϱ仯ʾǸƳͳ
+        TriangleApp* self = this;
+        if (IsRenderThreadEnabled()) {
+            GetRenderCommands().Record(&TriangleApp::CaptureRenderStats, self);
+        }
+        else {
+            CaptureRenderStats(&self);
+        }
+        RenderStats stats;
+        {
+            std::lock_guard<std::mutex> lock(m_RenderStatsMutex);
+            stats = m_RenderStats;
+        }
+
+        // ɫ壺ѡһʹʱű룬ֲ֧бʱڼþɱ
+        for (size_t i = 0; i < m_Shaders->GetFeatures().size(); ++i) {
+            bool enabled = (m_ShaderFeatures & (1u << i)) != 0;
+            if (i > 0) ImGui::SameLine();
+            if (ImGui::Checkbox(m_Shaders->GetFeatures()[i].c_str(), &enabled)) {
+                m_ShaderFeatures ^= (1u << i);
+            }
+        }
+        ImGui::Text("Shader variants: %zu compiled, %zu compiling, %d failed (parallel compile %s)",
+            stats.variantCount - stats.pendingVariants, stats.pendingVariants,
+            stats.failedVariants, Shader::IsParallelCompileEnabled() ? "on" : "off");
+        ImGui::Text("GL state calls last frame: %zu issued, %zu skipped as redundant%s",
+            stats.glIssued, stats.glRedundant, stats.glValidating ? " (validating)" : "");
+        const RenderQueue& queue = GetRenderQueue();
+        ImGui::Text("Render queue: %zu draws, %zu program / %zu material / %zu VAO changes, sort %.3f ms",
+            queue.GetDrawCount(), queue.GetProgramChanges(), queue.GetMaterialChanges(), queue.GetVertexArrayChanges(), queue.GetSortMilliseconds());
+        ImGui::Text("Shader cache: %s, %d hits, %d misses (%d rejected), saved %.2f ms",
+            stats.shaderCacheSupported ? "on" : "unsupported", stats.shaderCacheHits, stats.shaderCacheMisses,
+            stats.shaderCacheRejects, stats.shaderCacheSavedMilliseconds);
+        ImGui::Text("Stream buffer: %s, fence waits %d (%.2f ms), orphans %d",
+            stats.streamPersistent ? "persistent" : "unsynchronized",
+            stats.streamWaits, stats.streamWaitMilliseconds, stats.streamOrphans);
+
+        // Ⱦ̣߳лһ֡ʼʱЧ
+        bool renderThread = IsRenderThreadEnabled();
+        if (ImGui::Checkbox("Render thread", &renderThread)) {
+            SetRenderThreadEnabled(renderThread);
+        }
+        if (IsRenderThreadEnabled()) {
+            ImGui::SameLine();
+            ImGui::Text("main thread waited %.3f ms, replay %.3f ms", GetRenderThread().GetWaitMilliseconds(), GetRenderThread().GetReplayMilliseconds());
+        }
+        ImGui::Separator();
+
+        // 2.5 ѧ/ں˵ָֻѡֵ֧ĵλ
+        int simdLevel = static_cast<int>(GetActiveSimdLevel());
+        int supportedLevel = static_cast<int>(GetSupportedSimdLevel());
+        const char* simdNames[] = { "Scalar", "SSE2", "AVX2" };
+        if (ImGui::Combo("SIMD Kernels", &simdLevel, simdNames, supportedLevel + 1)) {
+            SetSimdLevelOverride(static_cast<SimdLevel>(simdLevel));
+            InvalidateTransformCache();  // ¼һΣʱʾں
+        }
+        ImGui::Separator();
+
+        // 2.6 Ϣ
         ImGui::Text("Application average %.3f ms/frame (%.1f FPS)",
             1000.0f / ImGui::GetIO().Framerate,
             ImGui::GetIO().Framerate);
+        ImGui::Checkbox("Show Profiler", &m_ShowProfiler);
+
+        // ģʽлһ֡Ч
+        FramePacer& pacer = GetFramePacer();
+        const char* presentModes[static_cast<int>(PresentMode::Count)];
+        for (int i = 0; i < static_cast<int>(PresentMode::Count); ++i) {
+            presentModes[i] = FramePacer::GetModeName(static_cast<PresentMode>(i));
+        }
+        int presentMode = static_cast<int>(pacer.GetMode());
+        if (ImGui::Combo("Present Mode", &presentMode, presentModes, static_cast<int>(PresentMode::Count))) {
+            pacer.SetMode(static_cast<PresentMode>(presentMode));
+        }
+        if (pacer.GetMode() == PresentMode::AdaptiveVSync && !pacer.IsAdaptiveVSyncSupported()) {
+            ImGui::Text("Adaptive vsync not supported by the driver, using vsync");
+        }
+        if (pacer.GetMode() == PresentMode::Limited) {
+            float targetRate = static_cast<float>(pacer.GetTargetRate());
+            if (ImGui::SliderFloat("Target FPS", &targetRate, 10.0f, 500.0f, "%.0f")) {
+                pacer.SetTargetRate(targetRate);
+            }
+            ImGui::Text("Sleep overshoot estimate %.3f ms", pacer.GetSleepOvershootMilliseconds());
+        }
+        ImGui::Text("Frame interval over %zu frames: avg %.3f ms, jitter %.3f ms (stddev), max deviation %.3f ms",
+            pacer.GetSampleCount(), pacer.GetAverageMilliseconds(), pacer.GetJitterMilliseconds(), pacer.GetMaxDeviationMilliseconds());
 
         ImGui::End();
     }
 }
 
-void TriangleApp::SetupShaders() {
-    // 1. ɫ
-    // ɫ
-    unsigned int vertexShader = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vertexShader, 1, &vertexShaderSource, NULL);
-    glCompileShader(vertexShader);
-
-    // 
-    int success;
-    char infoLog[512];
-    glGetShaderiv(vertexShader, GL_COMPILE_STATUS, &success);
-    if (!success) {
-        glGetShaderInfoLog(vertexShader, 512, NULL, infoLog);
-        std::cout << "Vertex shader compilation failed:\n" << infoLog << std::endl;
-    }
-
-    // Ƭɫ
-    unsigned int fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(fragmentShader, 1, &fragmentShaderSource, NULL);
-    glCompileShader(fragmentShader);
-    glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &success);
-    if (!success) {
-        glGetShaderInfoLog(fragmentShader, 512, NULL, infoLog);
-        std::cout << "Fragment shader compilation failed:\n" << infoLog << std::endl;
-    }
-
-    // 2. ɫ
-    m_ShaderProgram = glCreateProgram();
-    glAttachShader(m_ShaderProgram, vertexShader);
-    glAttachShader(m_ShaderProgram, fragmentShader);
-    glLinkProgram(m_ShaderProgram);
-    glGetProgramiv(m_ShaderProgram, GL_LINK_STATUS, &success);
-    if (!success) {
-        glGetProgramInfoLog(m_ShaderProgram, 512, NULL, infoLog);
-        std::cout << "Shader program linking failed:\n" << infoLog << std::endl;
+// 塢ʽͶSetupBuffersﰴСһΣ֮ٻ
+void TriangleApp::SetMeshVerticals(std::vector<float> verticals) {
+    assert(m_StaticVBO == 0 && "SetMeshVerticals must be called before Initialize");
+    if (m_StaticVBO != 0) {
+        std::cerr << "񻺳ѴInitialize֮ö" << std::endl;
+        return;
     }
-
-    // 3. ɾɫӵ
-    glDeleteShader(vertexShader);
-    glDeleteShader(fragmentShader);
+    allMeshVerticals = verticals;
 }
 
-void TriangleApp::SetMeshVerticals(std::vector<float> verticals) {
-    allMeshVerticals = verticals;
+void TriangleApp::SetMeshIndices(std::vector<unsigned int> indices) {
+    assert(m_StaticVBO == 0 && "SetMeshIndices must be called before Initialize");
+    if (m_StaticVBO != 0) {
+        std::cerr << "񻺳ѴInitialize֮" << std::endl;
+        return;
+    }
+    allMeshIndices = indices;
 }
 
 void TriangleApp::SetupBuffers()
 {
-    // 5. VAOVBO
-    glGenVertexArrays(1, &m_VAO);
-    glGenBuffers(1, &m_VBO);
-
-    // VAO,VBO
-    glBindVertexArray(m_VAO);
-    glBindBuffer(GL_ARRAY_BUFFER, m_VBO);
+    // 65536ʱ16λ
+    m_IndexType = (allMeshVerticals.size() / 3 <= 65536) ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+    size_t indexSize = (m_IndexType == GL_UNSIGNED_SHORT) ? sizeof(unsigned short) : sizeof(unsigned int);
+
+    // 5. ̬壺ģ궥ȫֻϴһ
+    // 㻺ģʽãפԴ棻ȫֻGPU任ģʽʹ
+    glGenVertexArrays(1, &m_StaticVAO);
+    glGenBuffers(1, &m_StaticVBO);
+    glGenBuffers(1, &m_StaticEBO);
+
+    GLStateCache& state = GetGLStateCache();
+    state.BindVertexArray(m_StaticVAO);
+    state.BindBuffer(GL_ARRAY_BUFFER, m_StaticVBO);
+    state.BindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_StaticEBO);
+    glBufferData(GL_ARRAY_BUFFER, allMeshVerticals.size() * sizeof(float), allMeshVerticals.data(), GL_STATIC_DRAW);
+    if (m_IndexType == GL_UNSIGNED_SHORT) {
+        std::vector<unsigned short> indices16(allMeshIndices.begin(), allMeshIndices.end());
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices16.size() * sizeof(unsigned short), indices16.data(), GL_STATIC_DRAW);
+    }
+    else {
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, allMeshIndices.size() * sizeof(unsigned int), allMeshIndices.data(), GL_STATIC_DRAW);
+    }
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
 
-    //bufferռ
-    glBufferData(GL_ARRAY_BUFFER, allMeshVerticals.size() * sizeof(float), allMeshVerticals.data(), GL_DYNAMIC_DRAW);
+    // 6. CPU޳ģʽÿֻ֡ѿɼεдʽ壬ÿΰȫɼ
+    // Ȼľ̬㻺ȡÿ֡ϴ
+    m_IndexStream.Create(allMeshIndices.size() * indexSize + sizeof(unsigned int));
+
+    // ޳õ궥ֻCPUڴ
+    worldVerticals.resize(allMeshVerticals.size());
+
+    // Ⱦ߳ģʽϴ壬Сʽһͬͬþ̬㻺
+    m_UploadCapacity = allMeshIndices.size() * indexSize + sizeof(unsigned int);
+    glGenBuffers(1, &m_UploadEBO);
+    glGenVertexArrays(1, &m_UploadVAO);
+    state.BindVertexArray(m_UploadVAO);
+    state.BindBuffer(GL_ARRAY_BUFFER, m_StaticVBO);
+    state.BindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_UploadEBO);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, m_UploadCapacity, nullptr, GL_STREAM_DRAW);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
 
-    // 6. öָ
-    // λ
+    // 7. öָ룬EBO󶨼¼VAO
+    glGenVertexArrays(1, &m_VAO);
+    state.BindVertexArray(m_VAO);
+    state.BindBuffer(GL_ARRAY_BUFFER, m_StaticVBO);
+    state.BindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_IndexStream.GetBuffer());
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
     glEnableVertexAttribArray(0);
+    state.BindVertexArray(0);
 }
 
 //VBO
-void TriangleApp::Update(float deltaTime)
+void TriangleApp::Simulate(double deltaTime)
 {
-    // VAO,VBO
-    glBindVertexArray(m_VAO);
-    glBindBuffer(GL_ARRAY_BUFFER, m_VBO);
-    
-    //任
-    //  x  45 +  y  45 ϲתޱֱӸʹã
-    float rotationMatrix[16] = {
-        0.70710678f,  0.5f,          0.5f,          0.0f,
-        0.0f,         0.70710678f,  -0.70710678f,  0.0f,
-        -0.70710678f, 0.5f,          0.5f,          0.0f,
-        0.0f,         0.0f,          0.0f,          1.0f
+    m_PreviousSpinYaw = m_SpinYaw;
+    m_SpinYaw += m_SpinSpeed * deltaTime;
+
+    // Ƕһƣֵ360
+    if (m_SpinYaw >= 360.0 || m_SpinYaw <= -360.0) {
+        double wrap = m_SpinYaw >= 360.0 ? 360.0 : -360.0;
+        m_SpinYaw -= wrap;
+        m_PreviousSpinYaw -= wrap;
+    }
+}
+
+void TriangleApp::Update(float /*deltaTime*/)
+{
+    // һ֡дʽ壺Ļһ֡Ļƶύһηfence
+    // лȾ߳ģʽʱfenceҲҪȾ߳Ϸ
+    bool recordUpload = IsRenderThreadEnabled();
+    if (m_StreamedThisFrame) {
+        if (recordUpload) {
+            TriangleApp* self = this;
+            GetRenderCommands().Record(&TriangleApp::EndIndexStreamFrame, self);
+        }
+        else {
+            m_IndexStream.EndFrame();
+        }
+        m_StreamedThisFrame = false;
+    }
+    if (recordUpload != m_UploadThroughCommands) {
+        m_UploadThroughCommands = recordUpload;
+        InvalidateTransformCache();
+    }
+
+    // ģ; = ̶ * yתǶûʱSetİ汾
+    // ԶתĽǶһģⲽ͵ǰֵ֮Ⱦ֡ʸģⲽʱȻƽ
+    double alpha = GetInterpolationAlpha();
+    double spinYaw = m_PreviousSpinYaw + (m_SpinYaw - m_PreviousSpinYaw) * alpha;
+    float yaw = static_cast<float>((m_ModelYaw + spinYaw) * (PI / 180.0));
+    float c = std::cos(yaw), s = std::sin(yaw);
+    const float yawMatrix[16] = {
+        c,    0.0f, -s,   0.0f,
+        0.0f, 1.0f, 0.0f, 0.0f,
+        s,    0.0f, c,    0.0f,
+        0.0f, 0.0f, 0.0f, 1.0f
     };
-    Vector3 screenNor = Vector3(0, 0, 1);
+    m_ModelMatrix.Set(m_BaseRotation * Mat4(yawMatrix));
 
-    //ģ任
-    std::vector<float> worldVertivals;
-    for (size_t i = 0; i < allMeshVerticals.size(); i+=3)
-    {
-        Vector3 point = Vector3(allMeshVerticals[i], allMeshVerticals[i+1], allMeshVerticals[i+2]);
-        Vector3 afterTrans = point.Transform(rotationMatrix);
+    // GPU任ģʽ̬SetupBuffersѾϴÿֻ֡uniform
+    if (m_UseGpuTransform) {
+        m_UploadBytes = 0;
+        return;
+    }
 
-        worldVertivals.push_back(afterTrans.x);
-        worldVertivals.push_back(afterTrans.y);
-        worldVertivals.push_back(afterTrans.z);
+    // ģ;û䣨Initialize֮󲻱䣩ʽϴεĽȻЧ֡ʲô
+    if (m_TransformCacheValid && m_CachedModelVersion == m_ModelMatrix.GetVersion()) {
+        ++m_CacheHits;
+        m_SkippedVertices += allMeshVerticals.size() / 3;
+        m_SkippedTriangles += allMeshIndices.size() / 3;
+        m_SkippedUploadBytes += m_CachedUploadBytes;
+        m_UploadBytes = 0;
+        return;
+    }
+    ++m_CacheMisses;
+    m_TransformCacheValid = false;
+
+    //ģ任ֻ꣨任ȥغΨһ㣩޳ʱɫ任
+    static_assert(sizeof(Vector3) == 3 * sizeof(float), "Vector3ǽе3float");
+    const Vector3* modelVertices = reinterpret_cast<const Vector3*>(allMeshVerticals.data());
+    Vector3* worldVertices = reinterpret_cast<Vector3*>(worldVerticals.data());
+    size_t vertexCount = allMeshVerticals.size() / 3;
+    size_t triangleCount = allMeshIndices.size() / 3;
+    size_t indexSize = (m_IndexType == GL_UNSIGNED_SHORT) ? sizeof(unsigned short) : sizeof(unsigned int);
+
+    // ߳ģʽʽһ䣬GPUڶһʱȴorphan
+    // Ⱦ߳ģʽд֡طϴʱſGL
+    void* indices = nullptr;
+    size_t indexOffset = 0;
+    if (recordUpload) {
+        indices = GetFrameAllocator().Allocate(allMeshIndices.size() * indexSize, indexSize);
+    }
+    else {
+        m_IndexStream.BeginFrame();
+        StreamBuffer::Allocation indexAlloc = m_IndexStream.Allocate(allMeshIndices.size() * indexSize, indexSize);
+        if (!indexAlloc.data) {
+            std::cerr << "ʽʧܣ֡" << std::endl;
+            m_IndexStream.Commit();
+            m_IndexStream.EndFrame();
+            m_UploadBytes = 0;
+            return;
+        }
+        indices = indexAlloc.data;
+        indexOffset = indexAlloc.offset;
     }
 
-    //޳
-    renderVerticals.clear();
-    for(int i = 0;i< worldVertivals.size();i+=9)
+    //ɼεֱдӳ壨֡
+    auto cullStart = std::chrono::steady_clock::now();
+    size_t indexCount = 0;
     {
-        //ķ,
-        Vector3 pointa = Vector3(worldVertivals[i], worldVertivals[i + 1], worldVertivals[i + 2]);
-        Vector3 pointb = Vector3(worldVertivals[i+3], worldVertivals[i + 4], worldVertivals[i + 5]);
-        Vector3 pointc = Vector3(worldVertivals[i+6], worldVertivals[i + 7], worldVertivals[i + 8]);
-
-
-
-        Vector3 faceNor = Vector3::CalculatePlaneNormal(pointa, pointb, pointc);
-        float dotRst = faceNor * screenNor;
-        if (dotRst < 0) {
-            renderVerticals.push_back(worldVertivals[i]);
-            renderVerticals.push_back(worldVertivals[i+1]);
-            renderVerticals.push_back(worldVertivals[i+2]);
-            renderVerticals.push_back(worldVertivals[i+3]);
-            renderVerticals.push_back(worldVertivals[i+4]);
-            renderVerticals.push_back(worldVertivals[i+5]);
-            renderVerticals.push_back(worldVertivals[i+6]);
-            renderVerticals.push_back(worldVertivals[i+7]);
-            renderVerticals.push_back(worldVertivals[i+8]);
+        PROFILE_ZONE("TransformAndCull");
+        if (m_UseParallelCull) {
+            //̣̱߳߳任һζ㣬ֿ޳ǰ׺ƴӣ뵥߳һ
+            if (m_IndexType == GL_UNSIGNED_SHORT) {
+                indexCount = ParallelTransformAndCull(GetJobSystem(), GetFrameAllocator().Current(), m_ModelMatrix.Get(), modelVertices, worldVertices,
+                    vertexCount, allMeshIndices.data(), triangleCount, static_cast<uint16_t*>(indices));
+            }
+            else {
+                indexCount = ParallelTransformAndCull(GetJobSystem(), GetFrameAllocator().Current(), m_ModelMatrix.Get(), modelVertices, worldVertices,
+                    vertexCount, allMeshIndices.data(), triangleCount, static_cast<uint32_t*>(indices));
+            }
+        }
+        else {
+            if (m_IndexType == GL_UNSIGNED_SHORT) {
+                indexCount = TransformAndCull(m_ModelMatrix.Get(), modelVertices, worldVertices, vertexCount,
+                    allMeshIndices.data(), triangleCount, static_cast<uint16_t*>(indices));
+            }
+            else {
+                indexCount = TransformAndCull(m_ModelMatrix.Get(), modelVertices, worldVertices, vertexCount,
+                    allMeshIndices.data(), triangleCount, static_cast<uint32_t*>(indices));
+            }
         }
     }
+    m_CullMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - cullStart).count();
+
+    m_UploadBytes = indexCount * indexSize;
+    if (recordUpload) {
+        UploadCommand upload = { this, indices, m_UploadBytes };
+        GetRenderCommands().Record(&TriangleApp::UploadIndices, upload);
+    }
+    else {
+        m_IndexStream.Commit();
+        m_StreamedThisFrame = true;
+    }
+
+    m_RenderIndexCount = static_cast<int>(indexCount);
+    m_RenderIndexOffset = indexOffset;
 
-    //VBO
-    glBufferData(GL_ARRAY_BUFFER, renderVerticals.size() * sizeof(float), renderVerticals.data(), GL_DYNAMIC_DRAW);
+    m_TransformCacheValid = true;
+    m_CachedModelVersion = m_ModelMatrix.GetVersion();
+    m_CachedUploadBytes = m_UploadBytes;
 }
\ No newline at end of file
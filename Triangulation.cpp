@@ -0,0 +1,159 @@
+﻿#include "Triangulation.h"
+#include <cmath>
+
+// 2D叉乘 (b - a) x (c - a)
+static inline float Cross2D(const float* p, uint32_t a, uint32_t b, uint32_t c)
+{
+    float abx = p[b * 2] - p[a * 2];
+    float aby = p[b * 2 + 1] - p[a * 2 + 1];
+    float acx = p[c * 2] - p[a * 2];
+    float acy = p[c * 2 + 1] - p[a * 2 + 1];
+    return abx * acy - aby * acx;
+}
+
+static void EmitFan(const uint32_t* vertices, size_t count, std::vector<uint32_t>& triangles)
+{
+    for (size_t i = 1; i + 1 < count; ++i)
+    {
+        triangles.push_back(vertices[0]);
+        triangles.push_back(vertices[i]);
+        triangles.push_back(vertices[i + 1]);
+    }
+}
+
+void TriangulatePolygon(const Vector3* points, size_t count, TriangulationScratch& scratch)
+{
+    std::vector<uint32_t>& triangles = scratch.triangles;
+    std::vector<uint32_t>& remaining = scratch.remaining;
+    triangles.clear();
+    if (count < 3)
+        return;
+
+    remaining.resize(count);
+    for (size_t i = 0; i < count; ++i)
+        remaining[i] = static_cast<uint32_t>(i);
+
+    if (count == 3)
+    {
+        EmitFan(remaining.data(), count, triangles);
+        return;
+    }
+
+    // 四边形：两个三角形朝向一致时沿0-2对角线剖分，否则0-2在多边形外，改用1-3
+    // 对不共面的四边形同样适用，且比通用路径便宜得多
+    if (count == 4)
+    {
+        Vector3 d1(points[1].x - points[0].x, points[1].y - points[0].y, points[1].z - points[0].z);
+        Vector3 d2(points[2].x - points[0].x, points[2].y - points[0].y, points[2].z - points[0].z);
+        Vector3 d3(points[3].x - points[0].x, points[3].y - points[0].y, points[3].z - points[0].z);
+        if (d1.Cross(d2) * d2.Cross(d3) >= 0.0f)
+        {
+            EmitFan(remaining.data(), count, triangles);
+        }
+        else
+        {
+            const uint32_t rotated[4] = { 1, 2, 3, 0 };
+            EmitFan(rotated, count, triangles);
+        }
+        return;
+    }
+
+    // 1. Newell法求多边形法线，去掉法线最大的分量投影到2D
+    float nx = 0.0f, ny = 0.0f, nz = 0.0f;
+    for (size_t i = 0; i < count; ++i)
+    {
+        const Vector3& a = points[i];
+        const Vector3& b = points[(i + 1) % count];
+        nx += (a.y - b.y) * (a.z + b.z);
+        ny += (a.z - b.z) * (a.x + b.x);
+        nz += (a.x - b.x) * (a.y + b.y);
+    }
+
+    float ax = std::fabs(nx), ay = std::fabs(ny), az = std::fabs(nz);
+    if (ax + ay + az < 1e-20f)
+    {
+        // 退化多边形（所有点共线），没有有意义的剖分，按扇形输出
+        EmitFan(remaining.data(), count, triangles);
+        return;
+    }
+
+    std::vector<float>& projected = scratch.projected;
+    projected.resize(count * 2);
+    for (size_t i = 0; i < count; ++i)
+    {
+        const Vector3& p = points[i];
+        if (ax >= ay && ax >= az) { projected[i * 2] = p.y; projected[i * 2 + 1] = p.z; }
+        else if (ay >= az)        { projected[i * 2] = p.z; projected[i * 2 + 1] = p.x; }
+        else                      { projected[i * 2] = p.x; projected[i * 2 + 1] = p.y; }
+    }
+    const float* p2 = projected.data();
+
+    // 投影后多边形的朝向，之后的凸性判断都乘上它
+    float orientation = 0.0f;
+    for (size_t i = 0; i < count; ++i)
+    {
+        size_t j = (i + 1) % count;
+        orientation += p2[i * 2] * p2[j * 2 + 1] - p2[j * 2] * p2[i * 2 + 1];
+    }
+    orientation = orientation >= 0.0f ? 1.0f : -1.0f;
+
+    // 2. 凸多边形直接扇形剖分
+    bool convex = true;
+    for (size_t i = 0; i < count && convex; ++i)
+    {
+        uint32_t a = static_cast<uint32_t>(i);
+        uint32_t b = static_cast<uint32_t>((i + 1) % count);
+        uint32_t c = static_cast<uint32_t>((i + 2) % count);
+        convex = Cross2D(p2, a, b, c) * orientation >= 0.0f;
+    }
+    if (convex)
+    {
+        EmitFan(remaining.data(), count, triangles);
+        return;
+    }
+
+    // 3. 凹多边形耳切
+    while (remaining.size() > 3)
+    {
+        size_t m = remaining.size();
+        bool clipped = false;
+
+        for (size_t i = 0; i < m && !clipped; ++i)
+        {
+            uint32_t a = remaining[(i + m - 1) % m];
+            uint32_t b = remaining[i];
+            uint32_t c = remaining[(i + 1) % m];
+
+            // 凹角或退化角不能作为耳朵
+            if (Cross2D(p2, a, b, c) * orientation <= 0.0f)
+                continue;
+
+            // 其余顶点都不能落在候选耳朵内（含边上）
+            bool empty = true;
+            for (size_t k = 0; k < m && empty; ++k)
+            {
+                uint32_t v = remaining[k];
+                if (v == a || v == b || v == c)
+                    continue;
+                if (Cross2D(p2, a, b, v) * orientation >= 0.0f &&
+                    Cross2D(p2, b, c, v) * orientation >= 0.0f &&
+                    Cross2D(p2, c, a, v) * orientation >= 0.0f)
+                    empty = false;
+            }
+            if (!empty)
+                continue;
+
+            triangles.push_back(a);
+            triangles.push_back(b);
+            triangles.push_back(c);
+            remaining.erase(remaining.begin() + i);
+            clipped = true;
+        }
+
+        // 自相交等无法找到耳朵的情况，剩余部分按扇形输出
+        if (!clipped)
+            break;
+    }
+
+    EmitFan(remaining.data(), remaining.size(), triangles);
+}
\ No newline at end of file
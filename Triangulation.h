@@ -0,0 +1,19 @@
+﻿#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "Vector3.h"
+
+// 三角化用的临时缓冲，跨多个面复用，避免每个面都分配内存
+struct TriangulationScratch
+{
+    std::vector<float> projected;     // 投影到2D后的坐标 (u0, v0, u1, v1, ...)
+    std::vector<uint32_t> remaining;  // 耳切时剩余的顶点
+    std::vector<uint32_t> triangles;  // 输出：多边形内的局部顶点下标，每3个一个三角形
+};
+
+// 三角化任意边数的平面多边形，保持原有绕序
+// 四边形按对角线两侧三角形的朝向选择对角线，凸四边形结果与 (0,1,2),(0,2,3) 一致
+// 其余凸多边形用扇形剖分，凹多边形用耳切法
+// 结果写入scratch.triangles
+void TriangulatePolygon(const Vector3* points, size_t count, TriangulationScratch& scratch);
\ No newline at end of file
@@ -0,0 +1,188 @@
+﻿// 变换+背面剔除微基准：TriangleApp::Update原来的逐顶点/逐三角形写法与批处理内核对比
+//
+// 构建：根目录CMakeLists.txt里的CullBenchmark目标（cmake --build build --target CullBenchmark）
+// 参数为球面的经纬分段数，三角形数约为 2 * n * n
+// 第二个参数强制内核指令集：scalar / sse2 / avx2，与环境变量 CENGINE_SIMD 相同
+// 第三个参数为多线程版本的最大线程数（默认硬件线程数），按1、2、4……逐档测试
+#include "BackFaceCulling.h"
+#include "Core/CpuFeatures.h"
+#include "Core/JobSystem.h"
+#include "Core/FrameAllocator.h"
+#include "Core/AllocationStats.h"
+#include <thread>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+static double NowSeconds()
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+template<typename Func>
+static double BestOf(int runs, const Func& func)
+{
+    double best = 1e30;
+    for (int r = 0; r < runs; ++r)
+    {
+        double start = NowSeconds();
+        func();
+        double elapsed = NowSeconds() - start;
+        if (elapsed < best) best = elapsed;
+    }
+    return best;
+}
+
+// 经纬球，顶点共享，绕序朝外
+static void BuildSphere(int segments, std::vector<Vector3>& vertices, std::vector<uint32_t>& indices)
+{
+    const float pi = 3.14159265f;
+    for (int i = 0; i <= segments; ++i)
+    {
+        float theta = pi * i / segments;
+        for (int j = 0; j <= segments; ++j)
+        {
+            float phi = 2.0f * pi * j / segments;
+            vertices.push_back(Vector3(std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi)));
+        }
+    }
+    for (int i = 0; i < segments; ++i)
+    {
+        for (int j = 0; j < segments; ++j)
+        {
+            uint32_t a = i * (segments + 1) + j;
+            uint32_t b = a + segments + 1;
+            indices.insert(indices.end(), { a, a + 1, b, a + 1, b + 1, b });
+        }
+    }
+}
+
+int main(int argc, char** argv)
+{
+    int segments = argc > 1 ? std::atoi(argv[1]) : 1000;
+    unsigned int maxThreads = argc > 3 ? static_cast<unsigned int>(std::atoi(argv[3])) : std::thread::hardware_concurrency();
+    if (maxThreads == 0) maxThreads = 1;
+
+    SimdLevel level;
+    if (argc > 2)
+    {
+        if (!ParseSimdLevel(argv[2], level))
+        {
+            std::printf("unknown SIMD level: %s\n", argv[2]);
+            return 1;
+        }
+        SetSimdLevelOverride(level);
+    }
+
+    std::vector<Vector3> vertices;
+    std::vector<uint32_t> indices;
+    BuildSphere(segments, vertices, indices);
+    size_t triangleCount = indices.size() / 3;
+
+    // 与TriangleApp中相同的旋转矩阵
+    const float matrix[16] = {
+        0.70710678f,  0.5f,          0.5f,          0.0f,
+        0.0f,         0.70710678f,  -0.70710678f,  0.0f,
+        -0.70710678f, 0.5f,          0.5f,          0.0f,
+        0.0f,         0.0f,          0.0f,          1.0f
+    };
+    Mat4 mat(matrix);
+
+    // 原写法：每帧新建vector逐个push_back，法向量归一化后再判断符号
+    std::vector<uint32_t> oldOutput;
+    double oldTime = BestOf(5, [&]() {
+        std::vector<float> world;
+        world.reserve(vertices.size() * 3);
+        for (size_t i = 0; i < vertices.size(); ++i)
+        {
+            Vector3 p = vertices[i].Transform(matrix);
+            world.push_back(p.x);
+            world.push_back(p.y);
+            world.push_back(p.z);
+        }
+        oldOutput.clear();
+        Vector3 screenNor(0, 0, 1);
+        for (size_t i = 0; i < indices.size(); i += 3)
+        {
+            uint32_t ia = indices[i], ib = indices[i + 1], ic = indices[i + 2];
+            Vector3 a(world[ia * 3], world[ia * 3 + 1], world[ia * 3 + 2]);
+            Vector3 b(world[ib * 3], world[ib * 3 + 1], world[ib * 3 + 2]);
+            Vector3 c(world[ic * 3], world[ic * 3 + 1], world[ic * 3 + 2]);
+            if (Vector3::CalculatePlaneNormal(a, b, c) * screenNor < 0)
+            {
+                oldOutput.push_back(ia);
+                oldOutput.push_back(ib);
+                oldOutput.push_back(ic);
+            }
+        }
+    });
+
+    std::vector<Vector3> world(vertices.size());
+    std::vector<uint32_t> newOutput(indices.size());
+    size_t newCount = 0;
+    double newTime = BestOf(5, [&]() {
+        newCount = TransformAndCull(mat, vertices.data(), world.data(), vertices.size(),
+            indices.data(), triangleCount, newOutput.data());
+    });
+
+    // 校验：用世界顶点逐个三角形按叉乘符号重新判断，结果应完全一致
+    std::vector<uint32_t> reference;
+    for (size_t i = 0; i < indices.size(); i += 3)
+    {
+        const Vector3& a = world[indices[i]];
+        const Vector3& b = world[indices[i + 1]];
+        const Vector3& c = world[indices[i + 2]];
+        if ((b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x) < 0.0f)
+            reference.insert(reference.end(), { indices[i], indices[i + 1], indices[i + 2] });
+    }
+    size_t mismatch = reference.size() == newCount ? 0 : 1;
+    for (size_t i = 0; mismatch == 0 && i < newCount; ++i)
+        if (reference[i] != newOutput[i]) mismatch = 1;
+
+    // 每帧的最少内存流量：读模型顶点、写世界顶点，剔除时再读世界顶点和索引，写可见索引
+    double bytes = vertices.size() * 36.0 + indices.size() * 4.0 + newCount * 4.0;
+
+    // 参考带宽：同样大小的memcpy
+    std::vector<char> copySource(static_cast<size_t>(bytes / 2), 1);
+    std::vector<char> copyTarget(copySource.size());
+    double copyTime = BestOf(5, [&]() {
+        std::memcpy(copyTarget.data(), copySource.data(), copySource.size());
+    });
+
+    const char* path = GetSimdLevelName(GetActiveSimdLevel());
+
+    std::printf("vertices: %zu, triangles: %zu, visible: %zu, path: %s\n", vertices.size(), triangleCount, newCount / 3, path);
+    std::printf("old Update loops   %8.3f ms\n", oldTime * 1000.0);
+    std::printf("TransformAndCull   %8.3f ms  %6.2f GB/s  (%.2fx)\n", newTime * 1000.0, bytes / newTime / 1e9, oldTime / newTime);
+    std::printf("memcpy bandwidth   %6.2f GB/s\n", copySource.size() * 2.0 / copyTime / 1e9);
+    std::printf("visible: old %zu, new %zu (old path also drops triangles whose normal is shorter than 1e-6)\n",
+        oldOutput.size() / 3, newCount / 3);
+    std::printf("matches reference: %s\n", mismatch ? "NO" : "yes");
+
+    // 多线程版本
+    std::printf("hardware threads: %u\n", std::thread::hardware_concurrency());
+    std::vector<uint32_t> parallelOutput(indices.size());
+    FrameAllocator frameAllocator(1024 * 1024);
+    for (unsigned int threads = 1; threads <= maxThreads; threads *= 2)
+    {
+        JobSystem jobSystem(threads - 1);
+        size_t parallelCount = 0;
+        size_t allocations = 0;
+        double parallelTime = BestOf(8, [&]() {
+            // 与Application的主循环一样，每帧先切换帧分配器；只统计最后一帧的堆分配次数
+            frameAllocator.BeginFrame();
+            size_t allocationsBefore = GetAllocationCount();
+            parallelCount = ParallelTransformAndCull(jobSystem, frameAllocator.Current(), mat, vertices.data(), world.data(),
+                vertices.size(), indices.data(), triangleCount, parallelOutput.data());
+            allocations = GetAllocationCount() - allocationsBefore;
+        });
+        bool same = parallelCount == newCount && std::memcmp(parallelOutput.data(), newOutput.data(), newCount * sizeof(uint32_t)) == 0;
+        if (!same) mismatch = 1;
+        std::printf("parallel %2u threads %8.3f ms  (%.2fx vs single-threaded)  %s, %zu heap allocations per frame\n", threads,
+            parallelTime * 1000.0, newTime / parallelTime, same ? "same output" : "OUTPUT DIFFERS", allocations);
+    }
+    return mismatch ? 1 : 0;
+}
\ No newline at end of file
@@ -0,0 +1,91 @@
+﻿// 任务系统基准：每个任务的调度开销，以及合成的每帧负载随线程数的扩展
+//
+// 构建：根目录CMakeLists.txt里的JobBenchmark目标（cmake --build build --target JobBenchmark）
+// 参数为最大线程数（含主线程），默认为硬件线程数
+#include "Core/JobSystem.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+static double NowSeconds()
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// 合成的每帧负载：对一组粒子做几十次浮点运算，计算量与数据量的比例和顶点变换相近
+static void SimulateRange(float* data, size_t begin, size_t end)
+{
+    for (size_t i = begin; i < end; ++i)
+    {
+        float v = data[i];
+        for (int k = 0; k < 16; ++k)
+            v = v * 0.999f + std::sin(v) * 0.001f;
+        data[i] = v;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    unsigned int hardwareThreads = std::thread::hardware_concurrency();
+    unsigned int maxThreads = argc > 1 ? static_cast<unsigned int>(std::atoi(argv[1])) : hardwareThreads;
+    if (maxThreads == 0) maxThreads = 1;
+    std::printf("hardware threads: %u\n", hardwareThreads);
+
+    // 1. 调度开销：提交并执行大量空任务
+    {
+        JobSystem jobs(maxThreads - 1);
+        const int jobCount = 200000;
+        JobCounter counter;
+        double start = NowSeconds();
+        for (int i = 0; i < jobCount; ++i)
+            jobs.Run([]() {}, &counter);
+        jobs.Wait(counter);
+        double elapsed = NowSeconds() - start;
+        std::printf("empty jobs: %d in %.2f ms, %.0f ns/job (%u threads, %zu stolen)\n",
+            jobCount, elapsed * 1000.0, elapsed * 1e9 / jobCount, jobs.GetThreadCount(), jobs.GetStolenCount());
+
+        // 依赖链：每个任务依赖上一个任务的计数器，测提交到执行的延迟
+        const int chainLength = 20000;
+        std::vector<std::unique_ptr<JobCounter>> chain;
+        for (int i = 0; i < chainLength; ++i)
+            chain.push_back(std::unique_ptr<JobCounter>(new JobCounter()));
+        start = NowSeconds();
+        for (int i = 0; i < chainLength; ++i)
+            jobs.Run([]() {}, chain[i].get(), i > 0 ? chain[i - 1].get() : nullptr);
+        jobs.Wait(*chain.back());
+        elapsed = NowSeconds() - start;
+        std::printf("dependency chain: %d jobs, %.0f ns/job\n", chainLength, elapsed * 1e9 / chainLength);
+    }
+
+    // 2. 扩展性：每帧一次ParallelFor，与串行循环对比
+    const size_t elementCount = 1 << 20;
+    const int frameCount = 20;
+    std::vector<float> data(elementCount);
+    for (size_t i = 0; i < elementCount; ++i)
+        data[i] = static_cast<float>(i % 1000) * 0.001f;
+
+    double start = NowSeconds();
+    for (int frame = 0; frame < frameCount; ++frame)
+        SimulateRange(data.data(), 0, elementCount);
+    double serialTime = (NowSeconds() - start) / frameCount;
+    std::printf("serial frame: %.3f ms\n", serialTime * 1000.0);
+
+    for (unsigned int threads = 1; threads <= maxThreads; threads *= 2)
+    {
+        JobSystem jobs(threads - 1);
+        start = NowSeconds();
+        for (int frame = 0; frame < frameCount; ++frame)
+        {
+            jobs.ParallelFor(elementCount, 0, [&](size_t begin, size_t end) {
+                SimulateRange(data.data(), begin, end);
+            });
+        }
+        double frameTime = (NowSeconds() - start) / frameCount;
+        std::printf("%2u threads: %.3f ms/frame, %.2fx\n", jobs.GetThreadCount(), frameTime * 1000.0, serialTime / frameTime);
+        if (threads * 2 > maxThreads && threads != maxThreads)
+            threads = maxThreads / 2;
+    }
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,122 @@
+﻿// 分区计时的开销：空循环里每次迭代进入/离开一个区，与不计时的循环对比
+// 每个区取两次时间戳，单独测一次取时间戳的耗时，区的开销减去两次时间戳即为记录本身的开销
+// （连续取时间戳测的是rdtsc的吞吐，区里的两次rdtsc可以和前后的指令重叠，所以区的开销可能小于两倍）
+// （虚拟机里rdtsc可能被拦截，比物理机慢几倍）
+// 另外在开着的情况下让一个线程持续Capture，确认读取不会拖慢写入方；单核机器上两个线程分时，这一项没有意义
+//
+// 构建：根目录CMakeLists.txt里的ProfilerBenchmark目标（cmake --build build --target ProfilerBenchmark）
+// 参数为每轮的区数，默认1000000；第二个参数为导出的trace路径（可选）
+#include "Core/Profiler.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+static double NowSeconds()
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+template<typename Func>
+static double BestOf(int runs, const Func& func)
+{
+    double best = 1e30;
+    for (int r = 0; r < runs; ++r)
+    {
+        double start = NowSeconds();
+        func();
+        double elapsed = NowSeconds() - start;
+        if (elapsed < best) best = elapsed;
+    }
+    return best;
+}
+
+// 不内联，循环体里有一次真实的调用，和被计时的代码一样
+#if defined(_MSC_VER)
+__declspec(noinline)
+#else
+__attribute__((noinline))
+#endif
+static void Work(volatile int& sink)
+{
+    sink = sink + 1;
+}
+
+static void Plain(size_t count, volatile int& sink)
+{
+    for (size_t i = 0; i < count; ++i)
+        Work(sink);
+}
+
+static void Zoned(size_t count, volatile int& sink)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        PROFILE_ZONE("Zoned");
+        Work(sink);
+    }
+}
+
+static void Nested(size_t count, volatile int& sink)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        PROFILE_ZONE("Outer");
+        {
+            PROFILE_ZONE("Inner");
+            Work(sink);
+        }
+    }
+}
+
+int main(int argc, char** argv)
+{
+    size_t count = argc > 1 ? static_cast<size_t>(std::atoll(argv[1])) : 1000000;
+    volatile int sink = 0;
+    Profiler& profiler = GetProfiler();
+    profiler.SetThreadName("Main");
+
+    double plain = BestOf(5, [&]() { Plain(count, sink); });
+    Profiler::SetEnabled(false);
+    double disabled = BestOf(5, [&]() { Zoned(count, sink); });
+    Profiler::SetEnabled(true);
+    double zoned = BestOf(5, [&]() { Zoned(count, sink); });
+    double nested = BestOf(5, [&]() { Nested(count, sink); });
+    uint64_t ticks = 0;
+    double clock = BestOf(5, [&]() {
+        for (size_t i = 0; i < count; ++i)
+            ticks += Profiler::Now();
+    });
+
+    // 读取方并发Capture最近1ms的记录
+    std::atomic<bool> stop(false);
+    std::atomic<size_t> captured(0);
+    std::thread reader([&]() {
+        std::vector<ProfileThreadCapture> captures;
+        while (!stop.load())
+        {
+            uint64_t now = Profiler::Now();
+            uint64_t window = static_cast<uint64_t>(1000000.0 / profiler.TicksToMilliseconds(1000000));     // 1ms的刻度数
+            GetProfiler().Capture(now > window ? now - window : 0, UINT64_MAX, captures);
+            for (const ProfileThreadCapture& capture : captures)
+                captured += capture.events.size();
+        }
+    });
+    double contended = BestOf(5, [&]() { Zoned(count, sink); });
+    stop = true;
+    reader.join();
+
+    std::printf("zones: %zu, clock: %s\n", count, profiler.IsUsingTsc() ? "rdtsc" : "steady_clock");
+    std::printf("clock read        %7.2f ns  (checksum %llu)\n", clock * 1e9 / count, static_cast<unsigned long long>(ticks & 0xFF));
+    std::printf("plain loop        %7.2f ns/iter\n", plain * 1e9 / count);
+    std::printf("zone (disabled)   %7.2f ns/iter  (+%.2f ns)\n", disabled * 1e9 / count, (disabled - plain) * 1e9 / count);
+    std::printf("zone              %7.2f ns/iter  (+%.2f ns)\n", zoned * 1e9 / count, (zoned - plain) * 1e9 / count);
+    std::printf("nested 2 zones    %7.2f ns/iter  (+%.2f ns per zone)\n", nested * 1e9 / count, (nested - plain) * 1e9 / count / 2);
+    std::printf("zone + reader     %7.2f ns/iter  (+%.2f ns), %zu events captured\n", contended * 1e9 / count, (contended - plain) * 1e9 / count, captured.load());
+
+    if (argc > 2 && !profiler.ExportChromeTrace(argv[2]))
+        return 1;
+    return 0;
+}
\ No newline at end of file
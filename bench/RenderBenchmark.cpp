@@ -0,0 +1,112 @@
+﻿// 整帧渲染基准：无头模式（EGL surfaceless + 离屏FBO）跑TriangleApp固定帧数，打印帧时间统计
+// 不需要显示器和GPU，Mesa的llvmpipe即可，用于在Linux的CI/性能测试机上发现渲染路径的性能回退
+//
+// 构建：根目录CMakeLists.txt里的RenderBenchmark目标，只在Linux上生成，需要libEGL
+//   cmake -S . -B build && cmake --build build --target RenderBenchmark
+// 参数：球面经纬分段数（三角形数约为 2 * n * n，默认256）、计时帧数（默认300）、
+//       渲染路径 cpu / cpu-serial / gpu（默认cpu），之后可以跟任意个选项：
+//       static（模型不转动，CPU路径每帧命中变换缓存）、threaded（渲染线程模式）、
+//       trace（结束后把分区计时导出到RenderBenchmark.json，可以用chrome://tracing或Perfetto打开）
+#include "Core/TriangleApp.h"
+#include "Core/Profiler.h"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+// 每帧把模型绕y轴转0.5度，CPU路径每帧都要重新变换和剔除
+class BenchmarkApp : public TriangleApp
+{
+public:
+    explicit BenchmarkApp(bool rotate) : m_Rotate(rotate), m_Yaw(0.0f) {}
+
+protected:
+    void Update(float deltaTime) override
+    {
+        if (m_Rotate)
+        {
+            m_Yaw = std::fmod(m_Yaw + 0.5f, 360.0f);
+            SetModelYaw(m_Yaw);
+        }
+        TriangleApp::Update(deltaTime);
+    }
+
+private:
+    bool m_Rotate;
+    float m_Yaw;
+};
+
+// 经纬球，顶点共享，绕序与CullBenchmark相同
+static void BuildSphere(int segments, std::vector<float>& vertices, std::vector<unsigned int>& indices)
+{
+    const float pi = 3.14159265f;
+    for (int i = 0; i <= segments; ++i)
+    {
+        float theta = pi * i / segments;
+        for (int j = 0; j <= segments; ++j)
+        {
+            float phi = 2.0f * pi * j / segments;
+            vertices.insert(vertices.end(), { std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi) });
+        }
+    }
+    for (int i = 0; i < segments; ++i)
+    {
+        for (int j = 0; j < segments; ++j)
+        {
+            unsigned int a = i * (segments + 1) + j;
+            unsigned int b = a + segments + 1;
+            indices.insert(indices.end(), { a, a + 1, b, a + 1, b + 1, b });
+        }
+    }
+}
+
+int main(int argc, char** argv)
+{
+    int segments = argc > 1 ? std::atoi(argv[1]) : 256;
+    int frames = argc > 2 ? std::atoi(argv[2]) : 300;
+    const char* path = argc > 3 ? argv[3] : "cpu";
+    bool rotate = true;
+    bool threaded = false;
+    bool trace = false;
+    for (int i = 4; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "static") == 0)
+            rotate = false;
+        else if (std::strcmp(argv[i], "threaded") == 0)
+            threaded = true;
+        else if (std::strcmp(argv[i], "trace") == 0)
+            trace = true;
+        else
+        {
+            std::printf("unknown option: %s\n", argv[i]);
+            return 1;
+        }
+    }
+
+    bool gpu = std::strcmp(path, "gpu") == 0;
+    bool serial = std::strcmp(path, "cpu-serial") == 0;
+    if (!gpu && !serial && std::strcmp(path, "cpu") != 0)
+    {
+        std::printf("unknown path: %s\n", path);
+        return 1;
+    }
+
+    std::vector<float> vertices;
+    std::vector<unsigned int> indices;
+    BuildSphere(segments, vertices, indices);
+    std::printf("vertices: %zu, triangles: %zu, path: %s%s%s\n", vertices.size() / 3, indices.size() / 3, path,
+        rotate ? "" : " (static)", threaded ? " (render thread)" : "");
+
+    BenchmarkApp app(rotate);
+    app.SetMeshVerticals(vertices);
+    app.SetMeshIndices(indices);
+    app.SetGpuTransform(gpu);
+    app.SetParallelCull(!serial);
+    app.SetRenderThreadEnabled(threaded);
+    if (!app.RunHeadless(frames))
+        return 1;
+    if (trace && !GetProfiler().ExportChromeTrace("RenderBenchmark.json"))
+        return 1;
+    return 0;
+}
\ No newline at end of file
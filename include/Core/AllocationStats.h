@@ -0,0 +1,9 @@
+﻿#pragma once
+#include <cstddef>
+
+// 全局operator new/delete的调用计数（AllocationStats.cpp中替换了全局operator new）
+// 只统计经过operator new的C++分配；ImGui、GLFW和驱动直接调用malloc的部分不在其中
+// 计数跨线程累计，Application每帧前后各取一次差值，得到一帧内的分配次数
+size_t GetAllocationCount();
+size_t GetAllocatedBytes();
+size_t GetFreeCount();
\ No newline at end of file
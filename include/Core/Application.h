@@ -1,6 +1,16 @@
 #pragma once
+#include <memory>
 #include <string>
 
+class JobSystem;
+class FrameAllocator;
+class ShaderCache;
+class RenderQueue;
+class RenderCommandList;
+class RenderThread;
+class FramePacer;
+class HeadlessContext;
+
 class Application
 {
 public:
@@ -9,24 +19,131 @@ public:
 
     void Run();  // Ӧõѭ
 
+    // ͷģʽڣEGLȾFBOֻ֧LinuxûImGui
+    // warmupFrames֡Ԥȣɫ롢潨ټʱframeCount֡ӡCPUύʱͺglFinish֡ʱͳ
+    // ǲ֡ʣ֡Ӱ죻ĴʧܻʱGLʱfalse
+    // Ⱦ߳ģʽֻ߳¼ƣ֡ʱѭļȴȾ̣߳ӡ̵߳ȴͻطŵƽʱ
+    bool RunHeadless(int frameCount, int warmupFrames = 10);
+
+    // Ⱦ̣߳GLĽרẉֻ̂߳߳¼ȾȾ߳һ֡طŲ
+    // Run֮ǰãһ֡ʼʱлĬϹرգGLö߳
+    void SetRenderThreadEnabled(bool enabled) { m_RenderThreadRequested = enabled; }
+
 protected:
     // Ҫдڷ
     virtual void Initialize() {}     // ʼԴ
-    virtual void Update(float deltaTime) {}  // ÿ֡
+    virtual void Simulate(double /*deltaTime*/) {}  // ģⲽSetFixedTimestep
+    virtual void Update(float /*deltaTime*/) {}  // ÿ֡£ڱ֡Simulate֮
     virtual void Render() {}         // ÿ֡Ⱦ
     virtual void OnImGuiRender() {}  // ImGuiȾ
     virtual void Shutdown() {}       // Դ
 
+    // ϵͳInitialize֮ǰShutdown֮٣ڷﶼʹ
+    JobSystem& GetJobSystem() { return *m_JobSystem; }
+
+    // ֡ÿ֡ʼʱգUpdate/Renderʱݴ䣬ֻƶָ
+    // ֡һ֡ǰЧ
+    FrameAllocator& GetFrameAllocator() { return *m_FrameAllocator; }
+
+    // ɫƻ棨Ŀ¼ShaderCache/GLĴʼ֧ʱδ
+    ShaderCache& GetShaderCache() { return *m_ShaderCache; }
+
+    // ƶУRenderύưRenderغб¼һִже
+    // ύĻصcontextҪֵ֡ط꣬Է֡Աֻܷ֮޸ĵ
+    // Ⱦ߳ģʽ·¼ƵݰĶУͳ֡ǰǴִе
+    RenderQueue& GetRenderQueue() { return *m_RecordingQueue; }
+
+    // ֡ȾֻUpdate/Render/OnImGuiRender¼ƣ߳ģʽڱ֡ʱط
+    // Ⱦ߳ģʽȾ߳һ֡ڼطţʱ߳ûGLģGLöҪ¼Ƴ
+    RenderCommandList& GetRenderCommands() { return *m_RecordingCommands; }
+
+    // ֡ǷȾ߳ģʽ£BeginEngineFrameʱȷһ֮֡ڲ䣩
+    bool IsRenderThreadEnabled() const;
+    RenderThread& GetRenderThread() { return *m_RenderThread; }
+
+    // ࣺ֡ģʽ/ֱͬ/Ӧ/֡֡ͳƣпл
+    FramePacer& GetFramePacer() { return *m_FramePacer; }
+
+    // ̶ģ⣺step > 0ʱÿ֡ۻʵʱɴSimulate(step)ģ⿪Ⱦ֡޹
+    // һ֡maxStepsPerFrameΣٺѹֱӶGetDroppedSimulationTimeԽ׷Խ
+    // step <= 0ʱΪɱ䲽ÿ֡ñ֡deltaTimeһSimulate
+    // ĬϹ̶1/60룬ÿ֡5
+    void SetFixedTimestep(double step, int maxStepsPerFrame = 5);
+    double GetFixedTimestep() const { return m_FixedTimestep; }
+    int GetMaxStepsPerFrame() const { return m_MaxStepsPerFrame; }
+
+    // ۻﲻһʣʱ / 0~1UpdateRenderһ͵ǰ״ֵ̬֮
+    // ɱ䲽ʱ1
+    double GetInterpolationAlpha() const { return m_InterpolationAlpha; }
+    int GetStepsLastFrame() const { return m_StepsLastFrame; }
+    double GetSimulationTime() const { return m_SimulationTime; }  // ģʱ䣨룩
+    double GetDroppedSimulationTime() const { return m_DroppedSimulationTime; }
+
+    // һ֡BeginFrameǰoperator newĴֽȶʱӦΪ0
+    size_t GetFrameAllocationCount() const { return m_FrameAllocationCount; }
+    size_t GetFrameAllocatedBytes() const { return m_FrameAllocatedBytes; }
+
 private:
     std::string m_Title;
     int m_Width;
     int m_Height;
     void* m_Window;  // GLFWwindow*
-    float m_LastFrameTime;
+    double m_LastFrameTime;     // 룬doubleڳʱк΢뾫
+    std::unique_ptr<JobSystem> m_JobSystem;
+    std::unique_ptr<FrameAllocator> m_FrameAllocator;
+    std::unique_ptr<ShaderCache> m_ShaderCache;
+    std::unique_ptr<RenderQueue> m_RenderQueue;
+    std::unique_ptr<FramePacer> m_FramePacer;   // ʱRun֮ǰͿ
+    int m_SwapInterval;     // ǰӦõĽ
+
+    // ̶ģ
+    double m_FixedTimestep;
+    int m_MaxStepsPerFrame;
+    double m_Accumulator;
+    double m_InterpolationAlpha;
+    int m_StepsLastFrame;
+    long long m_SimulationSteps;    // ̶ģʽµܲģʱ䰴˲㣬ۻ
+    double m_VariableSimulationTime;    // ɱ䲽ģʽۼӵģʱ
+    double m_SimulationTime;
+    double m_DroppedSimulationTime;
+    size_t m_FrameAllocationCount;
+    size_t m_FrameAllocatedBytes;
+    size_t m_FrameStartAllocationCount;
+    size_t m_FrameStartAllocatedBytes;
+
+    // ȾȾ߳
+    std::unique_ptr<RenderCommandList> m_RenderCommands;    // ߳ģʽ¼Ƶ
+    std::unique_ptr<RenderThread> m_RenderThread;
+    bool m_RenderThreadRequested;
+    bool m_FlushAfterSubmit;    // ֡ύȾ̻߳ط꣬EndImGuiFrame
+    RenderCommandList* m_RecordingCommands;     // ֡¼Ƶб߳ʱΪԱΪݰ
+    RenderQueue* m_RecordingQueue;
+    HeadlessContext* m_HeadlessContext;     // RunHeadlessڼЧ
+
+    // ںͷģʽԵлͳ֣ڳĵ߳ϵãappΪApplication
+    void (*m_SetContextCurrent)(void* app, bool current);
+    void (*m_Present)(void* app, int swapInterval);
+    static void SetWindowContextCurrent(void* app, bool current);
+    static void PresentWindow(void* app, int swapInterval);
+    static void SetHeadlessContextCurrent(void* app, bool current);
+    static void PresentHeadless(void* app, int swapInterval);
+
+    // ģʽọ̃ApplicationCore.cppҪǰGL
+    void StartEngine();     // ϵͳInitialize
+    void StopEngine();      // Shutdownϵͳ
+    void BeginEngineFrame();    // /ֹͣȾ̣߳ȡ֡¼õбͶ
+    void UpdateAndRender(double deltaTime);
+    void EndEngineFrame();      // ߳ģʽ»طű֡
+    void PresentFrame(bool paced);  // pacedΪfalseʱ֡ࣨͷģʽ
+    void StopRenderThread();    // طύ֡GLĻص߳
 
     // ImGui˽з
     bool InitializeImGui();
     void ShutdownImGui();
     void BeginImGuiFrame();
-    void EndImGuiFrame();
+    void EndImGuiFrame();      // ¼ImGuiĻ
+
+    // Ⱦ߳ģʽImGuiĻһ֡NewFrameʱʧЧݰһݣApplication.cpp
+    struct ImGuiFrameSnapshot;
+    ImGuiFrameSnapshot* m_ImGuiSnapshots[2];
 };
\ No newline at end of file
@@ -0,0 +1,41 @@
+﻿#pragma once
+
+// 运行时检测到的CPU特性，第一次调用GetCpuFeatures时检测一次
+// AVX系列同时检查了操作系统是否保存对应的寄存器状态（XGETBV）
+struct CpuFeatures
+{
+    bool sse2 = false;
+    bool sse41 = false;
+    bool sse42 = false;
+    bool avx = false;
+    bool avx2 = false;
+    bool fma = false;
+    bool avx512f = false;
+    bool invariantTsc = false;  // TSC频率恒定且在深度睡眠中不停，可以直接当时钟用
+};
+
+// 数学/网格内核的指令集档位，从低到高
+enum class SimdLevel
+{
+    Scalar = 0,
+    SSE2,
+    AVX2,   // AVX2 + FMA
+};
+
+const CpuFeatures& GetCpuFeatures();
+
+// 本机支持的最高档位
+SimdLevel GetSupportedSimdLevel();
+
+// 当前使用的档位
+// 默认为本机支持的最高档位，可以用环境变量 CENGINE_SIMD=scalar|sse2|avx2 覆盖
+SimdLevel GetActiveSimdLevel();
+
+// 强制使用指定档位（基准测试、控制窗口用），高于本机支持的档位时降到支持的最高档位，返回实际生效的档位
+// 可以在运行中任何线程上设置；已经取到内核表的调用（如一次ParallelTransformAndCull）仍用旧档位做完
+SimdLevel SetSimdLevelOverride(SimdLevel level);
+
+const char* GetSimdLevelName(SimdLevel level);
+
+// "scalar" / "sse2" / "avx2"，不区分大小写
+bool ParseSimdLevel(const char* name, SimdLevel& level);
\ No newline at end of file
@@ -0,0 +1,91 @@
+﻿#pragma once
+#include <cstddef>
+#include <new>
+#include <vector>
+
+// 线性分配器：在一整块内存上按指针递增分配，不能单独释放，Reset后整体复用
+// 容量不够时临时向系统申请溢出块（计入GetOverflowCount），下次Reset时按峰值扩容，
+// 之后同样负载的帧不再调用malloc
+// 不是线程安全的：在主线程上分配好，再把指针交给任务
+class LinearAllocator
+{
+public:
+    explicit LinearAllocator(size_t capacity = 0);
+    ~LinearAllocator();
+
+    // alignment必须是2的幂
+    void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+    template<typename T>
+    T* AllocateArray(size_t count) { return static_cast<T*>(Allocate(count * sizeof(T), alignof(T))); }
+
+    // 释放本轮所有分配；上一轮溢出过时先扩容到峰值
+    void Reset();
+
+    size_t GetUsed() const { return m_Offset + m_OverflowBytes; }
+    size_t GetCapacity() const { return m_Capacity; }
+    size_t GetPeak() const { return m_Peak; }
+    int GetOverflowCount() const { return m_OverflowCount; }
+
+private:
+    LinearAllocator(const LinearAllocator&) = delete;
+    LinearAllocator& operator=(const LinearAllocator&) = delete;
+
+    char* m_Buffer;
+    size_t m_Capacity;
+    size_t m_Offset;                // m_Buffer中已用的字节数
+    size_t m_OverflowBytes;         // 本轮溢出块的总字节数
+    size_t m_Peak;                  // 历史上一轮内分配的最大字节数
+    std::vector<void*> m_Overflow;  // 本轮的溢出块，Reset时释放
+    int m_OverflowCount;            // 累计溢出次数
+};
+
+// 双缓冲的帧分配器：每帧开始时切换到另一块并清空
+// 本帧分配的数据在下一帧结束前都有效，可以交给晚一帧消费的一方（例如GPU上传、渲染线程）
+class FrameAllocator
+{
+public:
+    explicit FrameAllocator(size_t capacityPerFrame);
+
+    void BeginFrame();
+
+    LinearAllocator& Current() { return m_Arenas[m_Current]; }
+    void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t)) { return Current().Allocate(size, alignment); }
+
+    template<typename T>
+    T* AllocateArray(size_t count) { return Current().AllocateArray<T>(count); }
+
+private:
+    LinearAllocator m_Arenas[2];
+    int m_Current;
+};
+
+// STL分配器适配：让std::vector等容器从LinearAllocator取内存，deallocate什么也不做
+// 容器的生命周期不能超过分配器下一次Reset
+template<typename T>
+class ArenaAllocator
+{
+public:
+    typedef T value_type;
+
+    explicit ArenaAllocator(LinearAllocator& arena) : m_Arena(&arena) {}
+    template<typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) : m_Arena(other.GetArena()) {}
+
+    T* allocate(size_t count) { return m_Arena->AllocateArray<T>(count); }
+    void deallocate(T*, size_t) {}
+
+    LinearAllocator* GetArena() const { return m_Arena; }
+
+private:
+    LinearAllocator* m_Arena;
+};
+
+template<typename T, typename U>
+bool operator==(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) { return a.GetArena() == b.GetArena(); }
+template<typename T, typename U>
+bool operator!=(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) { return a.GetArena() != b.GetArena(); }
+
+// 每帧的临时数组：FrameVector<float> v(ArenaAllocator<float>(GetFrameAllocator().Current()));
+template<typename T>
+using FrameVector = std::vector<T, ArenaAllocator<T>>;
\ No newline at end of file
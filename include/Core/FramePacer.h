@@ -0,0 +1,82 @@
+﻿#pragma once
+#include <chrono>
+#include <cstddef>
+
+// 呈现模式
+//   Uncapped：交换间隔0，不限帧率，用来测实际吞吐
+//   VSync：交换间隔1
+//   AdaptiveVSync：交换间隔-1，赶上垂直同步时同步，晚了立即呈现（需要WGL/GLX_EXT_swap_control_tear）
+//   Limited：交换间隔0，由帧限制器按目标帧率等待
+enum class PresentMode
+{
+    Uncapped = 0,
+    VSync,
+    AdaptiveVSync,
+    Limited,
+    Count
+};
+
+// 帧节奏：保存当前选择的呈现模式，实现帧限制器，并统计帧间隔的抖动
+// 运行中随时可以切换模式，交换间隔由窗口前端在下一帧开始前应用（见GetSwapInterval）
+//
+// 帧限制器先sleep到截止时间前一小段，再自旋到截止时间
+// sleep会多睡多久与系统定时器精度有关（Windows默认约15.6ms），这里按观测到的最大超时动态估计，
+// 估计值之内的部分用自旋补齐；截止时间按周期累加，不会因为单帧的误差漂移
+class FramePacer
+{
+public:
+    FramePacer();
+
+    void SetMode(PresentMode mode);
+    PresentMode GetMode() const { return m_Mode; }
+    static const char* GetModeName(PresentMode mode);
+
+    // 目标帧率只影响Limited模式，限制在1~1000之间
+    void SetTargetRate(double framesPerSecond);
+    double GetTargetRate() const { return m_TargetRate; }
+
+    // 驱动不支持自适应垂直同步时由窗口前端设置为false，AdaptiveVSync退化为VSync
+    void SetAdaptiveVSyncSupported(bool supported) { m_AdaptiveSupported = supported; }
+    bool IsAdaptiveVSyncSupported() const { return m_AdaptiveSupported; }
+
+    // 当前模式对应的交换间隔
+    int GetSwapInterval() const;
+
+    // 交换缓冲前调用：Limited模式下等待到本帧的截止时间，其他模式直接返回
+    void WaitForNextFrame();
+
+    // 交换缓冲后调用，记录与上一帧的间隔
+    void EndFrame();
+
+    // 最近SampleCount帧的帧间隔统计（毫秒）
+    size_t GetSampleCount() const { return m_SampleCount; }
+    double GetAverageMilliseconds() const { return m_AverageMilliseconds; }
+    double GetJitterMilliseconds() const { return m_JitterMilliseconds; }      // 标准差
+    double GetMaxDeviationMilliseconds() const { return m_MaxDeviationMilliseconds; }  // 与平均值的最大偏差
+    double GetSleepOvershootMilliseconds() const { return m_SleepOvershoot * 1000.0; }
+
+private:
+    typedef std::chrono::steady_clock Clock;
+    static const size_t SampleCount = 120;
+
+    void ResetStats();
+
+    PresentMode m_Mode;
+    double m_TargetRate;
+    bool m_AdaptiveSupported;
+
+    // 帧限制器
+    Clock::time_point m_Deadline;
+    bool m_DeadlineValid;
+    double m_SleepOvershoot;    // 秒，sleep实际多睡时间的估计
+
+    // 帧间隔统计
+    Clock::time_point m_LastFrame;
+    bool m_LastFrameValid;
+    double m_Samples[SampleCount];
+    size_t m_SampleCount;
+    size_t m_NextSample;
+    double m_AverageMilliseconds;
+    double m_JitterMilliseconds;
+    double m_MaxDeviationMilliseconds;
+};
\ No newline at end of file
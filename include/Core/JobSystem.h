@@ -0,0 +1,162 @@
+﻿#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class JobSystem;
+
+// 任务计数器：Run时加1，任务执行完减1，归零表示这一组任务全部完成
+// 也可以作为其他任务的依赖：依赖的计数器归零后，等待它的任务才会被调度
+class JobCounter
+{
+public:
+    JobCounter() : m_Pending(0) {}
+
+    bool IsDone() const { return m_Pending.load(std::memory_order_acquire) == 0; }
+
+private:
+    friend class JobSystem;
+
+    JobCounter(const JobCounter&) = delete;
+    JobCounter& operator=(const JobCounter&) = delete;
+
+    struct WaitingJob
+    {
+        std::function<void()> function;
+        JobCounter* counter;
+    };
+
+    std::atomic<int> m_Pending;
+    std::mutex m_WaitingMutex;
+    std::vector<WaitingJob> m_Waiting;  // 依赖这个计数器、还没调度的任务
+};
+
+// 工作窃取任务调度器
+// 每个线程一个双端队列：自己从尾部取（后进先出，缓存友好），空闲线程从别人的头部偷（先进先出，偷到的通常是大块任务）
+// 主线程（创建JobSystem的线程）占0号队列，在Wait里也执行任务，不会干等
+class JobSystem
+{
+public:
+    // workerCount为0时按硬件线程数减1创建工作线程（主线程也参与执行）
+    explicit JobSystem(unsigned int workerCount = 0);
+    ~JobSystem();
+
+    // 工作线程数加上主线程
+    unsigned int GetThreadCount() const { return static_cast<unsigned int>(m_Queues.size()); }
+
+    // 提交一个任务；counter不为空时任务完成后减1
+    // dependency不为空且未完成时，任务等它归零后才会被调度
+    void Run(std::function<void()> job, JobCounter* counter = nullptr, JobCounter* dependency = nullptr);
+
+    // 等待counter归零，等待期间执行队列中的任务
+    // 销毁计数器之前必须Wait过它，只看IsDone不够：完成方可能还没退出对计数器的访问
+    void Wait(JobCounter& counter);
+
+    // 把[0, count)按grainSize切块并行执行func(begin, end)，返回时全部完成
+    // grainSize为0时按线程数自动切成约4倍线程数的块
+    template<typename Func>
+    void ParallelFor(size_t count, size_t grainSize, const Func& func);
+
+    // 统计：执行的任务数和被偷走执行的任务数（累计）
+    size_t GetExecutedCount() const { return m_ExecutedCount.load(std::memory_order_relaxed); }
+    size_t GetStolenCount() const { return m_StolenCount.load(std::memory_order_relaxed); }
+
+private:
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    // 区间任务的入口：ParallelFor用函数指针加上下文指针提交，不经过std::function，提交时不分配内存
+    typedef void (*RangeFunction)(const void* context, size_t begin, size_t end);
+
+    struct Job
+    {
+        std::function<void()> function;
+        RangeFunction range;    // 不为空时执行range(context, begin, end)，否则执行function
+        const void* context;
+        size_t begin;
+        size_t end;
+        JobCounter* counter;
+
+        Job() : range(nullptr), context(nullptr), begin(0), end(0), counter(nullptr) {}
+    };
+
+    // 环形数组实现的双端队列，容量只增不减，稳定运行时入队出队都不分配内存
+    struct WorkQueue
+    {
+        std::mutex mutex;
+        std::vector<Job> slots;
+        size_t head;
+        size_t count;
+
+        WorkQueue() : head(0), count(0) {}
+        void PushBack(Job&& job);
+        void PopBack(Job& job);
+        void PopFront(Job& job);
+    };
+
+    void RunRange(RangeFunction range, const void* context, size_t begin, size_t end, JobCounter* counter);
+    void Push(Job job);
+    bool TryPop(unsigned int queueIndex, Job& job);
+    bool TrySteal(unsigned int thiefIndex, Job& job);
+    bool TryRunOne(unsigned int queueIndex);
+    void Execute(Job& job);
+    void CompleteJob(JobCounter* counter);
+    void WorkerLoop(unsigned int queueIndex);
+    unsigned int CurrentQueueIndex() const;
+
+    std::vector<std::unique_ptr<WorkQueue>> m_Queues;
+    std::vector<std::thread> m_Workers;
+
+    // 空闲的工作线程在这里睡眠；m_QueuedCount是各队列中任务数之和
+    std::mutex m_SleepMutex;
+    std::condition_variable m_WakeCondition;
+    std::atomic<size_t> m_QueuedCount;
+    std::atomic<int> m_SleepingCount;
+    std::atomic<bool> m_Quit;
+
+    std::atomic<size_t> m_ExecutedCount;
+    std::atomic<size_t> m_StolenCount;
+};
+
+template<typename Func>
+void JobSystem::ParallelFor(size_t count, size_t grainSize, const Func& func)
+{
+    if (count == 0)
+        return;
+    if (grainSize == 0)
+    {
+        size_t chunkCount = static_cast<size_t>(GetThreadCount()) * 4;
+        grainSize = (count + chunkCount - 1) / chunkCount;
+    }
+
+    // 只有一块时直接在当前线程执行，不经过队列
+    if (grainSize >= count || GetThreadCount() == 1)
+    {
+        func(static_cast<size_t>(0), count);
+        return;
+    }
+
+    struct Invoker
+    {
+        static void Invoke(const void* context, size_t begin, size_t end)
+        {
+            (*static_cast<const Func*>(context))(begin, end);
+        }
+    };
+
+    JobCounter counter;
+    size_t begin = grainSize;
+    for (; begin < count; begin += grainSize)
+    {
+        size_t end = (count - begin > grainSize) ? begin + grainSize : count;
+        RunRange(&Invoker::Invoke, &func, begin, end, &counter);
+    }
+    // 第一块留给当前线程，然后边等边帮忙
+    func(static_cast<size_t>(0), grainSize);
+    Wait(counter);
+}
\ No newline at end of file
@@ -0,0 +1,34 @@
+﻿#pragma once
+#include <string>
+#include <cstddef>
+
+// 只读内存映射文件：把整个文件映射进地址空间，避免拷贝到中间缓冲区
+class MappedFile
+{
+public:
+    MappedFile();
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // 映射文件，失败返回false（空文件视为成功，GetSize()为0）
+    bool Open(const std::string& filepath);
+    void Close();
+
+    bool IsOpen() const { return m_IsOpen; }
+    const char* GetData() const { return m_Data; }
+    size_t GetSize() const { return m_Size; }
+
+private:
+    const char* m_Data;
+    size_t m_Size;
+    bool m_IsOpen;
+
+#ifdef _WIN32
+    void* m_FileHandle;     // HANDLE
+    void* m_MappingHandle;  // HANDLE
+#else
+    int m_FileDescriptor;
+#endif
+};
\ No newline at end of file
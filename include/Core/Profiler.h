@@ -0,0 +1,190 @@
+﻿#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define CENGINE_PROFILER_TSC 1
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define CENGINE_PROFILER_TSC 1
+#endif
+
+// CPU分区计时：PROFILE_ZONE("名字")在作用域开始和结束时各取一次时间戳，结束时写进本线程的环形缓冲
+//   void TriangleApp::Update(float deltaTime) { PROFILE_ZONE("TriangleApp::Update"); ... }
+// 名字、文件和行号在静态变量里，一条记录只有区信息的指针、两个时间戳和嵌套深度
+//
+// 每个线程第一次记录时取一个缓冲（加锁一次），之后只写自己的缓冲，不加锁
+// 进入区时不调用函数：缓冲指针和嵌套深度是内联的thread_local，取时间戳也内联；离开时调用一次Record写记录
+// 读取（火焰图、导出）和写入无锁并发：读完后按写入计数判断哪些记录在读的过程中被覆盖，丢掉这部分
+// 线程退出后缓冲归还，后来的线程复用，导出时同一个缓冲显示为同一条线程
+//
+// 时间戳：x86上CPU有不变TSC时用rdtsc，与steady_clock对照换算成微秒；否则直接用steady_clock
+// 定义CENGINE_DISABLE_PROFILER时宏展开为空；运行时也可以SetEnabled(false)，只剩一次判断
+
+struct ProfileZoneInfo
+{
+    const char* name;
+    const char* file;
+    int line;
+};
+
+// 一次区的记录，时间为计时器的原始刻度
+struct ProfileEvent
+{
+    const ProfileZoneInfo* zone;
+    uint64_t begin;
+    uint64_t end;
+    uint32_t depth;     // 嵌套深度，最外层为0
+};
+
+// 一个线程缓冲里读出的记录，按结束时间排序（外层区在内层区之后）
+struct ProfileThreadCapture
+{
+    unsigned int threadIndex;
+    char threadName[32];
+    std::vector<ProfileEvent> events;
+};
+
+class ProfileThreadBuffer;
+
+class Profiler
+{
+public:
+    // 每个线程缓冲的记录数，满了之后覆盖最旧的
+    static const size_t EventCapacity = 1 << 15;
+
+    Profiler();
+
+    static bool IsEnabled() { return s_Enabled.load(std::memory_order_relaxed); }
+    static void SetEnabled(bool enabled) { s_Enabled.store(enabled, std::memory_order_relaxed); }
+
+    // 当前时间的原始刻度
+    static uint64_t Now()
+    {
+#ifdef CENGINE_PROFILER_TSC
+        if (s_UseTsc)
+            return __rdtsc();
+#endif
+        return static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+    }
+    bool IsUsingTsc() const { return m_UseTsc; }
+
+    // 以下读取的接口只在一个线程上调用（主线程）
+    // 刻度换算成微秒（以Profiler创建的时刻为0点）；TSC的频率在Capture和导出时按已经过的时间重新校准
+    double ToMicroseconds(uint64_t ticks) const { return (static_cast<double>(ticks) - static_cast<double>(m_StartTicks)) * m_MicrosecondsPerTick; }
+    double TicksToMilliseconds(uint64_t ticks) const { return ticks * m_MicrosecondsPerTick / 1000.0; }
+
+    // 给当前线程命名，显示在火焰图和导出的trace里；最长31个字节
+    void SetThreadName(const char* name);
+
+    // 帧的起点，由主线程每帧开始时调用；火焰图显示最近一个完整的帧
+    void MarkFrame();
+    // 最近第n个完整帧（0为最近一帧）的起止刻度，记录的帧不够时返回false
+    bool GetFrameRange(int n, uint64_t& begin, uint64_t& end) const;
+
+    // 读出与[begin, end]有交集的记录，captures按线程缓冲重用，稳定后不再分配内存
+    // begin为0、end为UINT64_MAX时读出全部
+    void Capture(uint64_t begin, uint64_t end, std::vector<ProfileThreadCapture>& captures);
+
+    // 把所有线程缓冲里现有的记录写成Chrome trace JSON（chrome://tracing、Perfetto可以打开），失败时返回false
+    bool ExportChromeTrace(const char* path);
+
+    // 由ProfileScope调用
+    // 当前线程的缓冲，第一次调用时取一个；之后只是读一个thread_local指针
+    static ProfileThreadBuffer* GetThreadBuffer()
+    {
+        ProfileThreadBuffer* buffer = t_Buffer;
+        return buffer ? buffer : AcquireThreadBuffer();
+    }
+    // 进入时返回本线程当前的嵌套深度并加1，离开时减1
+    static uint32_t EnterZone() { return t_Depth++; }
+    static void LeaveZone() { --t_Depth; }
+    // 往buffer里写一条记录
+    static void Record(ProfileThreadBuffer* buffer, const ProfileZoneInfo* zone, uint64_t begin, uint64_t end, uint32_t depth);
+
+private:
+    Profiler(const Profiler&) = delete;
+    Profiler& operator=(const Profiler&) = delete;
+
+    friend struct ProfileThreadBufferOwner;
+    static ProfileThreadBuffer* AcquireThreadBuffer();
+    ProfileThreadBuffer* AcquireBuffer();
+    void ReleaseBuffer(ProfileThreadBuffer* buffer);
+    void Calibrate();
+
+    static std::atomic<bool> s_Enabled;
+    static bool s_UseTsc;       // 构造时确定，之后只读；线程都先经过GetProfiler()才会取时间戳
+
+    // 缓冲的归还放在Profiler.cpp里另一个有析构函数的thread_local里，这两个是常量初始化，读取没有初始化检查
+    static inline thread_local ProfileThreadBuffer* t_Buffer = nullptr;
+    static inline thread_local uint32_t t_Depth = 0;
+
+    bool m_UseTsc;
+    uint64_t m_StartTicks;
+    double m_StartSeconds;
+    double m_MicrosecondsPerTick;
+
+    std::mutex m_BuffersMutex;
+    std::vector<ProfileThreadBuffer*> m_Buffers;    // 所有创建过的缓冲，和Profiler一样不释放
+    std::vector<ProfileThreadBuffer*> m_FreeBuffers;
+    std::vector<uint64_t> m_CaptureIndices;     // Capture里记录的序号，用来丢掉被覆盖的记录
+
+    static const int FrameHistory = 64;
+    uint64_t m_FrameStarts[FrameHistory];
+    uint64_t m_FrameCount;
+};
+
+// 第一次调用时创建，之后不销毁：退出时还在运行的线程仍然可以写缓冲
+Profiler& GetProfiler();
+
+// 在构造和析构时取时间戳的作用域对象，通过PROFILE_ZONE使用
+class ProfileScope
+{
+public:
+    explicit ProfileScope(const ProfileZoneInfo* zone)
+        : m_Zone(zone), m_Buffer(nullptr), m_Begin(0), m_Depth(0)
+    {
+        if (Profiler::IsEnabled())
+        {
+            m_Buffer = Profiler::GetThreadBuffer();
+            m_Depth = Profiler::EnterZone();
+            m_Begin = Profiler::Now();
+        }
+    }
+
+    ~ProfileScope()
+    {
+        if (m_Buffer)
+        {
+            uint64_t end = Profiler::Now();
+            Profiler::LeaveZone();
+            Profiler::Record(m_Buffer, m_Zone, m_Begin, end, m_Depth);
+        }
+    }
+
+private:
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+    const ProfileZoneInfo* m_Zone;
+    ProfileThreadBuffer* m_Buffer;     // 进入时没有开启计时为nullptr，中途开启/关闭不会配对出错
+    uint64_t m_Begin;
+    uint32_t m_Depth;
+};
+
+#define CENGINE_PROFILE_CONCAT_INNER(a, b) a##b
+#define CENGINE_PROFILE_CONCAT(a, b) CENGINE_PROFILE_CONCAT_INNER(a, b)
+
+#ifndef CENGINE_DISABLE_PROFILER
+// name必须是字符串字面量或其他静态存储期的字符串
+#define PROFILE_ZONE(name) \
+    static const ProfileZoneInfo CENGINE_PROFILE_CONCAT(s_ProfileZone, __LINE__) = { name, __FILE__, __LINE__ }; \
+    ProfileScope CENGINE_PROFILE_CONCAT(profileScope, __LINE__)(&CENGINE_PROFILE_CONCAT(s_ProfileZone, __LINE__))
+#else
+#define PROFILE_ZONE(name) ((void)0)
+#endif
\ No newline at end of file
@@ -0,0 +1,26 @@
+﻿#pragma once
+#include <vector>
+#include "Core/Profiler.h"
+
+// 分区计时的ImGui窗口：最近一个完整帧里各线程的火焰图（横轴为时间，纵轴为嵌套深度），
+// 悬停显示区的名字、耗时和源码位置；可以暂停在当前帧，或把缓冲里的记录导出为Chrome trace
+class ProfilerWindow
+{
+public:
+    ProfilerWindow();
+
+    // 在ImGui帧内调用，open为false时不绘制
+    void Draw(bool* open);
+
+private:
+    ProfilerWindow(const ProfilerWindow&) = delete;
+    ProfilerWindow& operator=(const ProfilerWindow&) = delete;
+
+    std::vector<ProfileThreadCapture> m_Captures;   // 每帧重用
+    uint64_t m_FrameBegin;
+    uint64_t m_FrameEnd;
+    bool m_Paused;
+    float m_Zoom;               // 1为一帧正好占满窗口宽度
+    char m_ExportPath[256];
+    char m_ExportStatus[128];
+};
\ No newline at end of file
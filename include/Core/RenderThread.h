@@ -0,0 +1,74 @@
+﻿#pragma once
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include "Graphics/RenderCommandList.h"
+#include "Graphics/RenderQueue.h"
+
+// 一帧的渲染数据：主线程录制，GL线程回放
+struct FramePacket
+{
+    RenderCommandList commands;     // 按录制顺序回放，绘制队列的执行也是其中一条命令
+    RenderQueue queue;
+    int swapInterval;               // 呈现前应用的交换间隔
+    double replayMilliseconds;      // 上次回放（不含呈现）的耗时，由GL线程写入
+};
+
+// 渲染线程：拥有GL上下文，晚主线程一帧回放帧数据包并呈现
+// 两个数据包轮换：主线程录制第N+1帧的同时渲染线程回放第N帧；主线程开始录制第N+2帧前等待第N帧回放完
+// 数据包的交接经过互斥量，回放期间写入包里的数据（统计等），主线程重新拿到这个包时可以直接读
+class RenderThread
+{
+public:
+    // 在渲染线程上调用的回调，user为Start时传入的指针
+    typedef void (*ContextFunction)(void* user, bool current);     // 绑定/解绑GL上下文
+    typedef void (*PresentFunction)(void* user, int swapInterval);
+
+    RenderThread();
+    ~RenderThread();
+
+    // 调用前主线程需要先解绑GL上下文，线程启动后在渲染线程上绑定
+    void Start(ContextFunction setContextCurrent, PresentFunction present, void* user);
+
+    // 等待已提交的帧全部回放完，解绑上下文并结束线程；之后主线程可以重新绑定上下文
+    void Stop();
+    bool IsRunning() const { return m_Thread.joinable(); }
+
+    // 取下一帧要录制的数据包，两帧前用过的同一个包还没回放完时等待
+    FramePacket& BeginFrame();
+    FramePacket& GetRecordingPacket() { return m_Packets[m_SubmittedCount % 2]; }   // BeginFrame之后、SubmitFrame之前有效
+    void SubmitFrame();
+
+    // 等待已提交的帧全部回放完
+    void Flush();
+
+    // 正在录制的数据包序号（0或1），需要按帧轮换的外部数据可以用它索引
+    int GetRecordingIndex() const { return static_cast<int>(m_SubmittedCount % 2); }
+
+    // 上一次BeginFrame里主线程等待的时间，以及拿到的包上一次回放的耗时（两帧前）
+    double GetWaitMilliseconds() const { return m_WaitMilliseconds; }
+    double GetReplayMilliseconds() const { return m_ReplayMilliseconds; }
+
+private:
+    RenderThread(const RenderThread&) = delete;
+    RenderThread& operator=(const RenderThread&) = delete;
+
+    void ThreadMain();
+
+    FramePacket m_Packets[2];
+    ContextFunction m_SetContextCurrent;
+    PresentFunction m_Present;
+    void* m_User;
+
+    std::thread m_Thread;
+    std::mutex m_Mutex;
+    std::condition_variable m_SubmittedCondition;
+    std::condition_variable m_CompletedCondition;
+    uint64_t m_SubmittedCount;  // 只有主线程修改
+    uint64_t m_CompletedCount;
+    bool m_Quit;
+
+    double m_WaitMilliseconds;
+    double m_ReplayMilliseconds;
+};
\ No newline at end of file
@@ -0,0 +1,9 @@
+﻿#pragma once
+#include <cstdint>
+
+// 32位FNV-1a字符串哈希，constexpr，可以在编译期算好：
+//   static constexpr uint32_t kObjectColor = HashString("uObjectColor");
+constexpr uint32_t HashString(const char* str, uint32_t hash = 2166136261u)
+{
+    return *str ? HashString(str + 1, (hash ^ static_cast<uint8_t>(*str)) * 16777619u) : hash;
+}
\ No newline at end of file
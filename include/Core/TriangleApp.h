@@ -1,35 +1,137 @@
 #pragma once
 #include "../Core/Application.h"
+#include "../Math/VersionedMat4.h"
+#include "../Graphics/StreamBuffer.h"
+#include "../Graphics/ShaderPermutations.h"
+#include "../Graphics/RenderQueue.h"
+#include "../Core/ProfilerWindow.h"
+#include <atomic>
+#include <memory>
+#include <mutex>
 #include <vector>
 
 class TriangleApp : public Application
 {
 public:
     TriangleApp();
+    // ֻInitialize֮ǰã֮ûᱨ
     void SetMeshVerticals(std::vector<float> verticals);
+    void SetMeshIndices(std::vector<unsigned int> indices);
+
+    // ƴѡͬͷģʽܲлȾ·
+    void SetGpuTransform(bool enabled) { m_UseGpuTransform = enabled; }
+    void SetParallelCull(bool enabled) { m_UseParallelCull = enabled; InvalidateTransformCache(); }
+    void SetModelYaw(float degrees) { m_ModelYaw = degrees; }
 
 protected:
     void Initialize() override;
+    void Simulate(double deltaTime) override;
     void Update(float deltaTime) override;
     void Render() override;
     void OnImGuiRender() override;  // ʵImGuiȾ
     void Shutdown() override;
 
 private:
-    void SetupShaders();
     void SetupBuffers();
+    void InvalidateTransformCache() { m_TransformCacheValid = false; }
+
+    // ƶеuniformصʵcontextΪTriangleAppֻ󲻱Ĺ۲/ͶӰ󣩣ưΪ֡ģ;
+    static void SetMaterialUniforms(Shader& shader, const void* context);
+    static void SetDrawUniforms(Shader& shader, const void* context);
+
+    // ȾڳGLĵ߳ϻطţ߳ģʽ²Ҫӳٵֱӵ
+    struct ClearCommand { float color[4]; };
+    struct ShaderRequest { TriangleApp* app; uint32_t features; };
+    struct UploadCommand { TriangleApp* app; const void* indices; size_t bytes; };
+    static void ClearTarget(const void* data);
+    static void ResolveShader(const void* data);        // ѡеıʱm_ActiveShader
+    static void UploadIndices(const void* data);
+    static void EndIndexStreamFrame(const void* data);
+    static void CaptureRenderStats(const void* data);   // дm_RenderStats
 
 private:
     unsigned int m_VAO;
-    unsigned int m_VBO;
-    unsigned int m_ShaderProgram;
+    std::unique_ptr<ShaderPermutationSet> m_Shaders;    // ҪGLģInitializeﴴֻ֮ڳĵ߳ʹ
+    std::atomic<Shader*> m_ActiveShader;    // һɵѡб壻Ⱦ߳ģʽȾ̸߳£һ֡Ч
+    unsigned int m_ShaderFeatures;  // ƴﹴѡı忪
+
+    // ģ궥ϴһΣģʽãGPU任ģʽϴһȫ޳ҲGPU
+    unsigned int m_StaticVAO;
+    unsigned int m_StaticVBO;
+    unsigned int m_StaticEBO;
+    bool m_UseGpuTransform;     // ڿƴлCPU/GPU任
+    RenderMaterial m_CulledMaterial;    // GPUģʽդʱ޳
+    RenderMaterial m_PreCulledMaterial; // CPUģʽCPU޳
+
+    Mat4 m_BaseRotation;            // ̶ĳʼ
+    float m_ModelYaw;               // ƴyǶȣȣ
+    float m_SpinSpeed;              // Զתٶȣ/룩Simulateﰴƽ
+    double m_SpinYaw;               // ǰģⲽԶתǶ
+    double m_PreviousSpinYaw;       // һģⲽĽǶȣUpdateﰴֵϵ
+    VersionedMat4 m_ModelMatrix;    // m_BaseRotation * yתıʱ汾ż1
+    Mat4 m_ViewMatrix;
+    Mat4 m_ProjectionMatrix;
 
     // ImGuiƱ
     float m_ClearColor[4];      // ɫ
     float m_TriangleColors[9];  // RGBɫ
     bool m_ShowDemoWindow;      // ǷʾImGuiʾ
     bool m_ShowControlWindow;   // Ƿʾƴ
+    bool m_ShowProfiler;        // ǷʾʱĻͼ
+    ProfilerWindow m_ProfilerWindow;
+
+    std::vector<float> allMeshVerticals;    //meshݣȥغΨһ㣩
+    std::vector<unsigned int> allMeshIndices;   //mesh
+    std::vector<float> worldVerticals;      //任Ķ㣬ֻCPU޳ÿ֡
+
+    // CPU޳ģʽֻпɼεдֻʽ壬óפm_StaticVBO
+    StreamBuffer m_IndexStream;
+    unsigned int m_IndexType;   // GL_UNSIGNED_SHORT65536ʱ  GL_UNSIGNED_INT
+    int m_RenderIndexCount;
+    size_t m_RenderIndexOffset;     // ֡ʽеֽƫ
+    bool m_StreamedThisFrame;       // Updateдʽ壬ƶִкһ֡Updateͷfence
+    size_t m_UploadBytes;       // һ֡дʽֽ
+
+    // Ⱦ߳ģʽCPU޳̰߳ѿɼд֡¼ϴȾ߳orphanдm_UploadEBO
+    // ʽӳfenceҪGLģģʽ²ʹ
+    unsigned int m_UploadVAO;
+    unsigned int m_UploadEBO;
+    size_t m_UploadCapacity;
+    bool m_UploadThroughCommands;   // һ޳ߵ·лʱʧЧ
+
+    // CPU任ģʽĶ̱߳任+޳
+    bool m_UseParallelCull;     // ޳м仺֡ȡ
+    double m_CullMilliseconds;  // һα任+޳ĺʱ
+
+    // CPU任Ļ棺ģ;İ汾ûʱInitialize֮󲻱䣩ֱӸʽϴдĶ
+    bool m_TransformCacheValid;
+    unsigned int m_CachedModelVersion;
+    size_t m_CacheHits;
+    size_t m_CacheMisses;
+    size_t m_SkippedVertices;       // лʡĶ任ۼƣ
+    size_t m_SkippedTriangles;      // ʡ޳ۼƣ
+    size_t m_SkippedUploadBytes;    // ʡʽдֽۼƣ
+    size_t m_CachedUploadBytes;     // һ֡дֽ
 
-    std::vector<float> allMeshVerticals;    //mesh
-    std::vector<float> renderVerticals;
+    // Ⱦ߳޸ĵͳƣɫ塢ɫ桢ʽ塢GL״̬CaptureRenderStatsһݸƴ
+    struct RenderStats
+    {
+        size_t variantCount;
+        size_t pendingVariants;
+        int failedVariants;
+        bool shaderCacheSupported;
+        int shaderCacheHits;
+        int shaderCacheMisses;
+        int shaderCacheRejects;
+        double shaderCacheSavedMilliseconds;
+        bool streamPersistent;
+        int streamWaits;
+        double streamWaitMilliseconds;
+        int streamOrphans;
+        size_t glIssued;
+        size_t glRedundant;
+        bool glValidating;
+    };
+    std::mutex m_RenderStatsMutex;
+    RenderStats m_RenderStats;
 };
\ No newline at end of file
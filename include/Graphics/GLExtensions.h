@@ -0,0 +1,13 @@
+﻿#pragma once
+
+// 扩展查询和扩展函数加载，不依赖窗口库
+// 窗口模式用glfwGetProcAddress，无头模式用eglGetProcAddress，创建上下文后先调用SetGLProcLoader
+typedef void* (*GLProcLoader)(const char* name);
+
+void SetGLProcLoader(GLProcLoader loader);
+
+// 用glGetStringi逐个比较，需要当前有GL上下文
+bool IsGLExtensionSupported(const char* name);
+
+// 没有设置加载函数或驱动没有这个函数时返回nullptr
+void* GetGLProcAddress(const char* name);
\ No newline at end of file
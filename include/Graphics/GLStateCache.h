@@ -0,0 +1,79 @@
+﻿#pragma once
+#include <cstddef>
+
+// GL状态缓存：记录当前绑定的程序、VAO、缓冲、纹理和开关状态，与当前值相同的调用直接跳过
+// 引擎里改这些状态的GL调用都经过这里；ImGui后端会在绘制后恢复它改过的状态，不影响这里的记录
+// 其他绕过缓存改了状态的代码需要调用Invalidate()
+// 不是线程安全的，只在当前持有GL上下文的线程上使用（渲染线程模式下为渲染线程）
+//
+// 校验模式下每次调用都用glGet读回真实状态与记录比较，不一致时报错并以真实状态为准
+// 读回会让驱动同步，只用于调试；默认在调试版本（没有定义NDEBUG）中打开
+class GLStateCache
+{
+public:
+    GLStateCache();
+
+    // 所有记录置为未知，之后每种状态的第一次调用一定下发
+    void Invalidate();
+
+    void UseProgram(unsigned int program);
+    void BindVertexArray(unsigned int vao);
+    // GL_ELEMENT_ARRAY_BUFFER的绑定属于VAO，切换VAO后这一项的记录会被置为未知
+    void BindBuffer(unsigned int target, unsigned int buffer);
+    void BindTexture(unsigned int unit, unsigned int target, unsigned int texture);
+
+    void Enable(unsigned int capability) { SetCapability(capability, true); }
+    void Disable(unsigned int capability) { SetCapability(capability, false); }
+    void SetCapability(unsigned int capability, bool enabled);
+    void FrontFace(unsigned int mode);
+    void CullFace(unsigned int mode);
+
+    // 删除对象时GL会把当前绑定重置为0，通过这里删除以同步记录
+    void DeleteProgram(unsigned int program);
+    void DeleteVertexArray(unsigned int vao);
+    void DeleteBuffer(unsigned int buffer);
+    void DeleteTexture(unsigned int texture);
+
+    void SetValidation(bool enabled) { m_Validate = enabled; }
+    bool IsValidationEnabled() const { return m_Validate; }
+
+    // 每帧开始时调用，统计上一帧的下发/跳过次数
+    void BeginFrame();
+    size_t GetIssuedCount() const { return m_LastIssued; }
+    size_t GetRedundantCount() const { return m_LastRedundant; }
+    size_t GetMismatchCount() const { return m_MismatchCount; }    // 校验发现的不一致（累计）
+
+private:
+    GLStateCache(const GLStateCache&) = delete;
+    GLStateCache& operator=(const GLStateCache&) = delete;
+
+    static const unsigned int Unknown = 0xFFFFFFFFu;
+    static const int BufferTargetCount = 5;
+    static const int CapabilityCount = 6;
+    static const int TextureUnitCount = 16;
+    static const int TextureTargetCount = 2;
+
+    // 返回true表示需要下发；校验模式下先用真实状态修正记录
+    bool Track(unsigned int& shadow, unsigned int value, unsigned int queryEnum, const char* name);
+    void ValidateCapability(int index, unsigned int capability);
+    void ActiveTexture(unsigned int unit);
+
+    unsigned int m_Program;
+    unsigned int m_VertexArray;
+    unsigned int m_Buffers[BufferTargetCount];
+    unsigned int m_Capabilities[CapabilityCount];   // 0关、1开、Unknown
+    unsigned int m_ActiveTexture;
+    unsigned int m_Textures[TextureUnitCount][TextureTargetCount];
+    unsigned int m_FrontFace;
+    unsigned int m_CullFace;
+
+    bool m_Validate;
+    size_t m_Issued;
+    size_t m_Redundant;
+    size_t m_LastIssued;
+    size_t m_LastRedundant;
+    size_t m_MismatchCount;
+};
+
+// 全局唯一的状态缓存（GL上下文只有一个）
+GLStateCache& GetGLStateCache();
\ No newline at end of file
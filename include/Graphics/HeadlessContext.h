@@ -0,0 +1,37 @@
+﻿#pragma once
+
+// 无头GL上下文：不需要显示器和窗口系统，用于Linux上的CI和性能测试机
+// 通过EGL创建surfaceless上下文（Mesa的llvmpipe软件渲染即可），绘制到一个离屏FBO里
+// FBO有RGBA8颜色缓冲和24位深度缓冲，创建后保持绑定，引擎不会再绑定默认帧缓冲
+//
+// 只在Linux上实现，其他平台Create返回false
+class HeadlessContext
+{
+public:
+    HeadlessContext();
+    ~HeadlessContext();
+
+    // 创建3.3 core上下文并设为当前，加载glad，设置GL扩展函数加载器，创建并绑定FBO
+    bool Create(int width, int height);
+    void Destroy();
+
+    // 在当前线程上绑定/解绑上下文，用于把上下文交给渲染线程；同一时刻只能在一个线程上绑定
+    bool MakeCurrent();
+    void ReleaseCurrent();
+
+    unsigned int GetFramebuffer() const { return m_Framebuffer; }
+    int GetWidth() const { return m_Width; }
+    int GetHeight() const { return m_Height; }
+
+private:
+    HeadlessContext(const HeadlessContext&) = delete;
+    HeadlessContext& operator=(const HeadlessContext&) = delete;
+
+    void* m_Display;    // EGLDisplay
+    void* m_Context;    // EGLContext
+    unsigned int m_Framebuffer;
+    unsigned int m_ColorBuffer;
+    unsigned int m_DepthBuffer;
+    int m_Width;
+    int m_Height;
+};
\ No newline at end of file
@@ -0,0 +1,53 @@
+﻿#pragma once
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+// 渲染命令列表：录制引擎级的渲染命令（清屏、上传、执行绘制队列、绘制ImGui等），之后在拥有GL上下文的线程上按录制顺序回放
+// 单线程模式下每帧结束时在主线程上回放；渲染线程模式下主线程录制，渲染线程晚一帧回放
+//
+// 一条命令是函数指针加一份按值拷贝进列表内存的参数，参数类型必须可以按字节拷贝
+// 参数里的指针由录制方保证在回放时有效，帧内临时数据可以放在帧分配器里（见Application::GetFrameAllocator）
+// Reset保留容量，稳定运行后录制不分配内存
+class RenderCommandList
+{
+public:
+    typedef void (*CommandFunction)(const void* data);
+
+    RenderCommandList() {}
+
+    // function在回放时收到参数副本的地址
+    template<typename T>
+    void Record(CommandFunction function, const T& data)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "渲染命令的参数必须可以按字节拷贝");
+        static_assert(alignof(T) <= alignof(std::max_align_t), "渲染命令的参数对齐要求过高");
+        std::memcpy(Push(function, sizeof(T), alignof(T)), &data, sizeof(T));
+    }
+
+    // 不带参数的命令，回放时data为nullptr
+    void Record(CommandFunction function) { Push(function, 0, 1); }
+
+    void Execute() const;
+    void Reset();
+
+    size_t GetCommandCount() const { return m_Commands.size(); }
+    size_t GetDataBytes() const { return m_Data.size(); }
+
+private:
+    RenderCommandList(const RenderCommandList&) = delete;
+    RenderCommandList& operator=(const RenderCommandList&) = delete;
+
+    struct Command
+    {
+        CommandFunction function;
+        size_t offset;      // 参数在m_Data中的偏移，size为0时不使用
+        size_t size;
+    };
+
+    void* Push(CommandFunction function, size_t size, size_t alignment);
+
+    std::vector<Command> m_Commands;
+    std::vector<unsigned char> m_Data;  // operator new的内存按max_align_t对齐，偏移按参数类型对齐即可
+};
\ No newline at end of file
@@ -0,0 +1,92 @@
+﻿#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class Shader;
+
+// 绘制队列：各系统在Render里提交带64位排序键的绘制包，每帧排序一次后统一执行
+// 执行时只在程序、材质、VAO与上一个绘制包不同时才切换，切换代价越大的状态在键里的位越高
+//
+// 排序键布局（高位在前）：
+//   不透明：pass(4) | 程序(12) | 材质(12) | VAO(12) | 深度(24)  同一组状态内从前往后画，利于early-Z
+//   半透明：pass(4) | 反转深度(24) | 程序(12) | 材质(12) | VAO(12)  从后往前画，保证混合正确
+// 键里的程序/材质/VAO只取低12位，不同对象截断后相同只会影响分组，执行时按实际对象比较
+enum class RenderPass : uint8_t
+{
+    Opaque = 0,
+    Translucent = 1,
+    Overlay = 2
+};
+
+// 设置uniform的回调，context由提交方保证在Execute之前有效
+typedef void (*UniformFunction)(Shader& shader, const void* context);
+
+// 材质：固定管线状态和材质级的uniform，连续使用同一材质的绘制包只设置一次
+struct RenderMaterial
+{
+    bool depthTest;
+    bool cullFace;
+    unsigned int frontFace;     // GL_CW / GL_CCW
+    unsigned int cullMode;      // GL_BACK / GL_FRONT
+    UniformFunction setUniforms;    // 可以为空
+    const void* context;
+};
+
+struct DrawPacket
+{
+    Shader* shader;
+    const RenderMaterial* material;
+    unsigned int vertexArray;
+    unsigned int primitive;     // GL_TRIANGLES等
+    unsigned int indexType;     // GL_UNSIGNED_SHORT / GL_UNSIGNED_INT
+    int indexCount;
+    size_t indexOffset;         // 索引缓冲中的字节偏移
+    UniformFunction setUniforms;    // 每个绘制包的uniform（模型矩阵等），可以为空
+    const void* context;
+};
+
+class RenderQueue
+{
+public:
+    RenderQueue();
+
+    // depth为观察空间中到相机的距离，负数按0处理
+    static uint64_t MakeSortKey(RenderPass pass, uint32_t shader, uint32_t material, uint32_t vertexArray, float depth);
+
+    // 每帧开始时清空，保留容量，稳定运行后提交不再分配内存
+    void Reset();
+    void Submit(uint64_t key, const DrawPacket& packet);
+
+    // 按键排序后依次绘制，结束后队列清空
+    void Execute();
+
+    size_t GetPacketCount() const { return m_Packets.size(); }
+
+    // 上一次Execute的统计
+    size_t GetDrawCount() const { return m_DrawCount; }
+    size_t GetProgramChanges() const { return m_ProgramChanges; }
+    size_t GetMaterialChanges() const { return m_MaterialChanges; }
+    size_t GetVertexArrayChanges() const { return m_VertexArrayChanges; }
+    double GetSortMilliseconds() const { return m_SortMilliseconds; }
+
+private:
+    struct SortItem
+    {
+        uint64_t key;
+        uint32_t index;
+    };
+
+    // 按字节的LSD基数排序，所有键在某个字节上都相同时跳过这一趟
+    void Sort();
+
+    std::vector<DrawPacket> m_Packets;
+    std::vector<SortItem> m_Items;
+    std::vector<SortItem> m_Scratch;
+
+    size_t m_DrawCount;
+    size_t m_ProgramChanges;
+    size_t m_MaterialChanges;
+    size_t m_VertexArrayChanges;
+    double m_SortMilliseconds;
+};
\ No newline at end of file
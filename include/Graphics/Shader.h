@@ -1,22 +1,95 @@
 #pragma once
+#include <chrono>
+#include <cstdint>
 #include <string>
+#include <vector>
+#include "Core/StringHash.h"
+
+struct Mat4;
+class ShaderCache;
 
 class Shader
 {
 public:
-    Shader(const char* vertexSource, const char* fragmentSource);
+    // ImmediateʱɣԭΪһ
+    // DeferredʱֻύIsReady/Finishʱżں̨
+    enum class CompileMode { Immediate, Deferred };
+
+    // cacheΪʱȳԴӳƻأδٴԴ룬ɹдػ
+    Shader(const char* vertexSource, const char* fragmentSource, ShaderCache* cache = nullptr,
+        CompileMode mode = CompileMode::Immediate);
     ~Shader();
 
+    // ֧GL_KHR_parallel_shader_compileGL_ARB_parallel_shader_compileʱĺ̨߳
+    // ҪGLģǷ֧
+    static bool EnableParallelCompile();
+    static bool IsParallelCompileEnabled();
+
+    // ӳٱǷɣʱ˳ʧʱIsValidΪfalse
+    // бʱȴɺ󷵻true
+    bool IsReady();
+    // ȴӳٱɲ
+    void Finish();
+
     void Bind() const;
     void Unbind() const;
     unsigned int GetID() const { return m_ID; }
+    bool IsValid() const { return m_ID != 0 && !m_Pending; }
+
+    // Ӻuniformֻ¼һȥ"[0]"
+    struct Uniform
+    {
+        std::string name;
+        uint32_t hash;      // HashString(name)
+        int location;
+        unsigned int type;  // GL_FLOAT_VEC3
+        int size;           // 鳤ȣΪ1
+    };
+    const std::vector<Uniform>& GetUniforms() const { return m_Uniforms; }
+
+    // ֹϣuniformλãڣ򱻱Żʱ-1
+    int GetUniformLocation(uint32_t nameHash) const;
+    int GetUniformLocation(const char* name) const { return GetUniformLocation(HashString(name)); }
+
+    // ͻuniformãҪBind
+    // ֹϣHashStringڱãÿֻ֡һιϣٵglGetUniformLocation
+    // uniformʱʲôҲglUniform*-1Ϊһ
+    void SetInt(uint32_t nameHash, int value) const;
+    void SetFloat(uint32_t nameHash, float value) const;
+    void SetVec2(uint32_t nameHash, float x, float y) const;
+    void SetVec3(uint32_t nameHash, float x, float y, float z) const;
+    void SetVec3(uint32_t nameHash, const float* value) const;
+    void SetVec4(uint32_t nameHash, float x, float y, float z, float w) const;
+    void SetVec4(uint32_t nameHash, const float* value) const;
+    void SetMat4(uint32_t nameHash, const float* columnMajor) const;
+    void SetMat4(uint32_t nameHash, const Mat4& value) const;
 
 private:
+    Shader(const Shader&) = delete;
+    Shader& operator=(const Shader&) = delete;
+
     unsigned int m_ID;
+
+    // ӳٱڼ״̬
+    unsigned int m_VertexShader;
+    unsigned int m_FragmentShader;
+    bool m_Pending;
+    ShaderCache* m_Cache;
+    uint64_t m_CacheKey;
+    std::chrono::steady_clock::time_point m_CompileStart;
+
     unsigned int CompileShader(unsigned int type, const char* source);
 
     // ؼ޸ģunsigned int type
     bool CheckShaderCompileStatus(unsigned int shader, unsigned int type);
 
     bool CheckProgramLinkStatus(unsigned int program);
-};
\ No newline at end of file
+
+    // ӳɹglGetActiveUniformöuniformϣ
+    void ReflectUniforms();
+    const Uniform* FindUniform(uint32_t nameHash, unsigned int expectedType) const;
+
+    std::vector<Uniform> m_Uniforms;
+    // Ѱַϣλm_Uniforms±꣬-1ΪգΪ2uniform2
+    std::vector<int> m_UniformSlots;
+};
@@ -0,0 +1,54 @@
+﻿#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+// 着色器程序二进制缓存：链接好的程序用glGetProgramBinary存到磁盘，下次启动用glProgramBinary直接加载，跳过驱动编译
+//
+// 缓存键是源码加上GL_VENDOR/GL_RENDERER/GL_VERSION的64位哈希，换显卡或升级驱动后自然失效
+// 驱动拒绝某个二进制（链接状态为失败）时删掉该文件，调用方回退到从源码编译，编译后重新写入
+// 需要GL 4.1或GL_ARB_get_program_binary，驱动不支持任何二进制格式时IsSupported()为false，所有请求都算未命中
+//
+// 文件：directory/<16位十六进制键>.glbin，ShaderCacheHeader后面跟驱动返回的二进制
+class ShaderCache
+{
+public:
+    explicit ShaderCache(const std::string& directory);
+
+    // 需要在GL上下文创建后调用：读取驱动信息，加载程序二进制相关的函数，创建缓存目录
+    bool Initialize();
+    bool IsSupported() const { return m_Supported; }
+
+    uint64_t ComputeKey(const char* vertexSource, const char* fragmentSource) const;
+
+    // 命中时返回已链接的程序，否则返回0
+    unsigned int LoadProgram(uint64_t key);
+
+    // 链接之前调用：提示驱动保留二进制，部分驱动不设置就取不到
+    void PrepareProgram(unsigned int program) const;
+
+    // 链接成功后调用，compileMilliseconds是这次从源码编译+链接的耗时，命中时用来估算节省的时间
+    bool StoreProgram(uint64_t key, unsigned int program, double compileMilliseconds);
+
+    // 统计
+    int GetHitCount() const { return m_HitCount; }
+    int GetMissCount() const { return m_MissCount; }
+    int GetRejectCount() const { return m_RejectCount; }           // 驱动拒绝的二进制数（也计入未命中）
+    double GetLoadMilliseconds() const { return m_LoadMilliseconds; }      // 命中时加载二进制的累计耗时
+    double GetCompileMilliseconds() const { return m_CompileMilliseconds; } // 未命中时从源码编译的累计耗时
+    double GetSavedMilliseconds() const { return m_SavedMilliseconds; }    // 命中时（当初的编译耗时 - 加载耗时）之和
+
+private:
+    std::string GetPath(uint64_t key) const;
+
+    std::string m_Directory;
+    std::string m_DriverInfo;   // vendor + renderer + version
+    bool m_Supported;
+
+    int m_HitCount;
+    int m_MissCount;
+    int m_RejectCount;
+    double m_LoadMilliseconds;
+    double m_CompileMilliseconds;
+    double m_SavedMilliseconds;
+};
\ No newline at end of file
@@ -0,0 +1,59 @@
+﻿#pragma once
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "Graphics/Shader.h"
+
+// 着色器变体：同一份源码，按开关的组合在#version之后注入#define，得到不同的程序
+// 每个开关占变体掩码的一位，变体在第一次使用时才编译
+//
+// 驱动支持并行编译（见Shader::EnableParallelCompile）时，新变体在驱动的后台线程编译，
+// 编译完成前Get返回nullptr，调用方继续用已有的变体画，不会卡住这一帧
+// 不支持时，第一次Get某个变体会同步编译
+class ShaderPermutationSet
+{
+public:
+    // features为开关名，第i个对应掩码的第i位，最多32个
+    ShaderPermutationSet(const char* vertexSource, const char* fragmentSource,
+        const std::vector<std::string>& features, ShaderCache* cache = nullptr);
+
+    // 开关名对应的掩码位，不存在时返回0
+    uint32_t GetFeatureBit(const char* feature) const;
+    const std::vector<std::string>& GetFeatures() const { return m_Features; }
+
+    // 取变体：已编译完成且有效时返回，否则返回nullptr（还在编译，或编译失败）
+    Shader* Get(uint32_t mask);
+
+    // 取变体，还在编译时等待编译完成，用于第一帧就要用的变体；编译失败时返回nullptr
+    Shader* Require(uint32_t mask);
+
+    // 只提交编译不等待，例如预计马上会用到的变体
+    void Prewarm(uint32_t mask);
+
+    // 注入#define后的源码
+    std::string BuildSource(const std::string& source, uint32_t mask) const;
+
+    // 统计
+    size_t GetVariantCount() const { return m_Variants.size(); }
+    size_t GetPendingCount() const;
+    int GetFailedCount() const { return m_FailedCount; }
+
+private:
+    void Create(uint32_t mask);
+    Shader* Resolve(uint32_t mask, bool wait);
+
+    std::string m_VertexSource;
+    std::string m_FragmentSource;
+    std::vector<std::string> m_Features;
+    ShaderCache* m_Cache;
+
+    struct Variant
+    {
+        std::unique_ptr<Shader> shader;
+        bool pending;
+    };
+    std::unordered_map<uint32_t, Variant> m_Variants;
+    int m_FailedCount;
+};
\ No newline at end of file
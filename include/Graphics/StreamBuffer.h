@@ -0,0 +1,75 @@
+﻿#pragma once
+#include <cstddef>
+
+// 流式缓冲：CPU每帧生成的顶点/索引直接写进映射好的GL缓冲
+// 缓冲分成regionCount段（默认3段）轮流使用，每段用完后放一个fence，
+// 再次轮到这一段时如果GPU还没读完就等待，保证不会改写GPU正在使用的数据
+//
+// 支持GL 4.4或ARB_buffer_storage时用持久映射（PERSISTENT | COHERENT），整个生命周期只映射一次
+// 否则（GL 3.3）每帧对当前段做非同步映射（UNSYNCHRONIZED），段仍被GPU占用时把整块缓冲orphan掉，不等待
+//
+// 每帧的用法：
+//   BeginFrame() -> Allocate()若干次并写入 -> Commit() -> 绘制 -> EndFrame()
+class StreamBuffer
+{
+public:
+    struct Allocation
+    {
+        void* data;     // CPU写入地址，分配失败时为nullptr
+        size_t offset;  // 相对缓冲起点的字节偏移，作为glVertexAttribPointer/glDrawElements的偏移
+        size_t size;
+    };
+
+    StreamBuffer();
+    ~StreamBuffer();
+
+    // 顶点和索引都可以用，绘制时按需要绑定到GL_ARRAY_BUFFER或GL_ELEMENT_ARRAY_BUFFER
+    // 需要在GL上下文创建后调用
+    bool Create(size_t regionSize, int regionCount = 3);
+    void Destroy();
+
+    // 切换到下一段，必要时等待该段的fence
+    void BeginFrame();
+
+    // 在当前段中分配，偏移按alignment的整数倍对齐（不要求是2的幂，例如顶点步长12）
+    // 当前段剩余空间不足时返回data为nullptr
+    Allocation Allocate(size_t size, size_t alignment = 16);
+
+    // 写完、绘制前调用：非持久映射时解除映射
+    void Commit();
+
+    // 本帧使用当前段的绘制命令都提交之后调用，在当前段放置fence
+    void EndFrame();
+
+    unsigned int GetBuffer() const { return m_Buffer; }
+    size_t GetRegionSize() const { return m_RegionSize; }
+    bool IsPersistent() const { return m_Persistent; }
+
+    // 统计：等待fence的次数与累计时间，以及orphan次数
+    int GetWaitCount() const { return m_WaitCount; }
+    double GetWaitMilliseconds() const { return m_WaitMilliseconds; }
+    int GetOrphanCount() const { return m_OrphanCount; }
+
+private:
+    StreamBuffer(const StreamBuffer&) = delete;
+    StreamBuffer& operator=(const StreamBuffer&) = delete;
+
+    static const int MaxRegions = 4;
+
+    void WaitForRegion(int region);
+
+    unsigned int m_Buffer;
+    size_t m_RegionSize;
+    int m_RegionCount;
+    int m_CurrentRegion;
+    size_t m_RegionUsed;        // 当前段已分配的字节数
+    bool m_Persistent;
+
+    unsigned char* m_PersistentData;    // 持久映射时整块缓冲的地址
+    unsigned char* m_RegionData;        // 当前段的映射地址
+    void* m_Fences[MaxRegions];         // GLsync
+
+    int m_WaitCount;
+    double m_WaitMilliseconds;
+    int m_OrphanCount;
+};
\ No newline at end of file
@@ -0,0 +1,31 @@
+﻿#pragma once
+#include <cstddef>
+#include "Math/Vec4.h"
+
+// 16字节对齐的4x4矩阵
+// 列主序存储，与Vector3::Transform和OpenGL一致：第j列为m[4j..4j+3]
+struct alignas(16) Mat4
+{
+    float m[16];
+
+    Mat4();  // 单位矩阵
+    explicit Mat4(const float columnMajor[16]);
+
+    static Mat4 Identity() { return Mat4(); }
+
+    // 可直接传给Vector3::Transform或glUniformMatrix4fv(transpose = GL_FALSE)
+    const float* Data() const { return m; }
+
+    Mat4 operator*(const Mat4& rhs) const;
+
+    // 一般4x4矩阵求逆，奇异矩阵的结果包含inf/nan
+    Mat4 Inverse() const;
+
+    Vec4 Transform(const Vec4& v) const;
+    Vector3 TransformPoint(const Vector3& p) const;          // w = 1，包含平移
+    Vector3 TransformDirection(const Vector3& d) const;      // w = 0，忽略平移
+
+    // 批量变换，in和out可以是同一个数组
+    void TransformPoints(const Vector3* in, Vector3* out, size_t count) const;
+    void TransformDirections(const Vector3* in, Vector3* out, size_t count) const;
+};
\ No newline at end of file
@@ -0,0 +1,29 @@
+﻿#pragma once
+#include <cstdint>
+#include <cstddef>
+#include "Core/CpuFeatures.h"
+#include "Vector3.h"
+
+// 按指令集分开编译的热点内核
+// 每个档位一张函数表，启动后按GetActiveSimdLevel选择，调用方不需要关心当前指令集
+struct MathKernels
+{
+    SimdLevel level;
+
+    // 批量变换紧密排列的Vector3，matrix为列主序4x4；w为1变换点，为0变换方向
+    // in和out可以是同一个数组
+    void (*transformVector3)(const float* matrix, const Vector3* in, Vector3* out, size_t count, float w);
+
+    // 背面剔除，语义见BackFaceCulling.h
+    size_t (*cullBackFaces16)(const Vector3* vertices, const uint32_t* indices, size_t triangleCount, uint16_t* output);
+    size_t (*cullBackFaces32)(const Vector3* vertices, const uint32_t* indices, size_t triangleCount, uint32_t* output);
+};
+
+// 当前档位的函数表
+const MathKernels& GetMathKernels();
+
+// 指定档位的函数表，该档位没有编译进来时返回nullptr
+// 每个档位在自己的编译单元里实现：MathKernels.cpp（标量）、MathKernelsSSE2.cpp、MathKernelsAVX2.cpp
+const MathKernels* GetScalarMathKernels();
+const MathKernels* GetSse2MathKernels();
+const MathKernels* GetAvx2MathKernels();
\ No newline at end of file
@@ -0,0 +1,49 @@
+﻿#pragma once
+#include <cstdint>
+#include <cstddef>
+#include "Vector3.h"
+
+// 各档位共用的标量代码，用于标量档位和SIMD循环的尾部
+// 都是static函数：被不同指令集的编译单元包含时各自生成一份，
+// 不会因为链接器合并inline函数而让低档位的代码用上高档位的指令
+
+// w为1时变换点，为0时变换方向
+static inline void TransformVector3Scalar(const float* m, const Vector3* in, Vector3* out, size_t begin, size_t end, float w)
+{
+    for (size_t i = begin; i < end; ++i)
+    {
+        float x = in[i].x, y = in[i].y, z = in[i].z;
+        out[i].x = m[0] * x + m[4] * y + m[8] * z + m[12] * w;
+        out[i].y = m[1] * x + m[5] * y + m[9] * z + m[13] * w;
+        out[i].z = m[2] * x + m[6] * y + m[10] * z + m[14] * w;
+    }
+}
+
+// 写出一个三角形，visible为0时写入的内容会被下一个三角形覆盖
+// 不分支，可见性随机分布时也没有分支预测失败
+template<typename IndexType>
+static inline size_t EmitTriangle(const uint32_t* triangle, IndexType* output, size_t count, uint32_t visible)
+{
+    output[count] = static_cast<IndexType>(triangle[0]);
+    output[count + 1] = static_cast<IndexType>(triangle[1]);
+    output[count + 2] = static_cast<IndexType>(triangle[2]);
+    return count + 3 * visible;
+}
+
+// 逐个三角形剔除[begin, end)，从output[count]开始写，返回新的count
+template<typename IndexType>
+static size_t CullRangeScalar(const Vector3* vertices, const uint32_t* indices, size_t begin, size_t end,
+    IndexType* output, size_t count)
+{
+    for (size_t t = begin; t < end; ++t)
+    {
+        const uint32_t* triangle = indices + t * 3;
+        const Vector3& a = vertices[triangle[0]];
+        const Vector3& b = vertices[triangle[1]];
+        const Vector3& c = vertices[triangle[2]];
+
+        float crossZ = (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+        count = EmitTriangle(triangle, output, count, crossZ < 0.0f ? 1u : 0u);
+    }
+    return count;
+}
\ No newline at end of file
@@ -0,0 +1,15 @@
+﻿#pragma once
+
+// SIMD指令集检测
+// CENGINE_SIMD_SSE2：x64和开启/arch:SSE2的x86上总是可用
+// CENGINE_SIMD_AVX2：当前编译单元开启了AVX2（/arch:AVX2 或 -mavx2 -mfma）
+//   工程里只有MathKernelsAVX2.cpp单独开启，运行时是否使用由CpuFeatures决定
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CENGINE_SIMD_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#if defined(CENGINE_SIMD_SSE2) && defined(__AVX2__)
+#define CENGINE_SIMD_AVX2 1
+#include <immintrin.h>
+#endif
\ No newline at end of file
@@ -0,0 +1,65 @@
+﻿#pragma once
+#include "Math/SimdConfig.h"
+
+// SIMD内部工具：shuffle宏和AoS/SoA转置
+// 只给数学库和网格内核的实现文件使用
+
+#ifdef CENGINE_SIMD_SSE2
+
+#define CE_SHUFFLE_MASK(x, y, z, w) ((x) | ((y) << 2) | ((z) << 4) | ((w) << 6))
+#define CE_SWIZZLE(v, x, y, z, w) _mm_castsi128_ps(_mm_shuffle_epi32(_mm_castps_si128(v), CE_SHUFFLE_MASK(x, y, z, w)))
+#define CE_SHUFFLE(a, b, x, y, z, w) _mm_shuffle_ps(a, b, CE_SHUFFLE_MASK(x, y, z, w))
+
+#ifdef CENGINE_SIMD_AVX2
+// 8个紧密排列的Vector3（24个float）与x/y/z各8通道之间的转换
+// 先按固定位置混合三个寄存器，再用一次通道置换排好顺序
+static inline void LoadSoA8(const float* p, __m256& x, __m256& y, __m256& z)
+{
+    __m256 a = _mm256_loadu_ps(p);
+    __m256 b = _mm256_loadu_ps(p + 8);
+    __m256 c = _mm256_loadu_ps(p + 16);
+
+    x = _mm256_blend_ps(_mm256_blend_ps(a, b, 0x92), c, 0x24);
+    y = _mm256_blend_ps(_mm256_blend_ps(a, b, 0x24), c, 0x49);
+    z = _mm256_blend_ps(_mm256_blend_ps(a, b, 0x49), c, 0x92);
+
+    x = _mm256_permutevar8x32_ps(x, _mm256_setr_epi32(0, 3, 6, 1, 4, 7, 2, 5));
+    y = _mm256_permutevar8x32_ps(y, _mm256_setr_epi32(1, 4, 7, 2, 5, 0, 3, 6));
+    z = _mm256_permutevar8x32_ps(z, _mm256_setr_epi32(2, 5, 0, 3, 6, 1, 4, 7));
+}
+
+static inline void StoreSoA8(float* p, __m256 x, __m256 y, __m256 z)
+{
+    x = _mm256_permutevar8x32_ps(x, _mm256_setr_epi32(0, 3, 6, 1, 4, 7, 2, 5));
+    y = _mm256_permutevar8x32_ps(y, _mm256_setr_epi32(5, 0, 3, 6, 1, 4, 7, 2));
+    z = _mm256_permutevar8x32_ps(z, _mm256_setr_epi32(2, 5, 0, 3, 6, 1, 4, 7));
+
+    _mm256_storeu_ps(p, _mm256_blend_ps(_mm256_blend_ps(x, y, 0x92), z, 0x24));
+    _mm256_storeu_ps(p + 8, _mm256_blend_ps(_mm256_blend_ps(x, y, 0x24), z, 0x49));
+    _mm256_storeu_ps(p + 16, _mm256_blend_ps(_mm256_blend_ps(x, y, 0x49), z, 0x92));
+}
+#endif
+
+// 4个紧密排列的Vector3（12个float）与x/y/z各4通道之间的转换
+static inline void LoadSoA4(const float* p, __m128& x, __m128& y, __m128& z)
+{
+    __m128 a = _mm_loadu_ps(p);      // x0 y0 z0 x1
+    __m128 b = _mm_loadu_ps(p + 4);  // y1 z1 x2 y2
+    __m128 c = _mm_loadu_ps(p + 8);  // z2 x3 y3 z3
+
+    x = CE_SHUFFLE(a, CE_SHUFFLE(b, c, 2, 2, 1, 1), 0, 3, 0, 2);
+    y = CE_SHUFFLE(CE_SHUFFLE(a, b, 1, 1, 0, 0), CE_SHUFFLE(b, c, 3, 3, 2, 2), 0, 2, 0, 2);
+    z = CE_SHUFFLE(CE_SHUFFLE(a, b, 2, 2, 1, 1), CE_SHUFFLE(c, c, 0, 0, 3, 3), 0, 2, 0, 2);
+}
+
+static inline void StoreSoA4(float* p, __m128 x, __m128 y, __m128 z)
+{
+    __m128 xy01 = _mm_unpacklo_ps(x, y);  // x0 y0 x1 y1
+    __m128 xy23 = _mm_unpackhi_ps(x, y);  // x2 y2 x3 y3
+
+    _mm_storeu_ps(p, CE_SHUFFLE(xy01, CE_SHUFFLE(z, x, 0, 0, 1, 1), 0, 1, 0, 2));
+    _mm_storeu_ps(p + 4, CE_SHUFFLE(CE_SHUFFLE(y, z, 1, 1, 1, 1), xy23, 0, 2, 0, 1));
+    _mm_storeu_ps(p + 8, CE_SHUFFLE(CE_SHUFFLE(z, x, 2, 2, 3, 3), CE_SHUFFLE(y, z, 3, 3, 3, 3), 0, 2, 0, 2));
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,33 @@
+﻿#pragma once
+#include "Math/SimdConfig.h"
+#include "Vector3.h"
+
+// 16字节对齐的4D向量，可直接用SSE寄存器加载
+struct alignas(16) Vec4
+{
+    float x, y, z, w;
+
+    Vec4() : x(0), y(0), z(0), w(0) {}
+    Vec4(float _x, float _y, float _z, float _w) : x(_x), y(_y), z(_z), w(_w) {}
+
+    // 与Vector3互转：点的w为1，方向的w为0
+    Vec4(const Vector3& v, float _w) : x(v.x), y(v.y), z(v.z), w(_w) {}
+    Vector3 ToVector3() const { return Vector3(x, y, z); }
+
+#ifdef CENGINE_SIMD_SSE2
+    __m128 Load() const { return _mm_load_ps(&x); }
+    static Vec4 FromSimd(__m128 v) { Vec4 r; _mm_store_ps(&r.x, v); return r; }
+
+    Vec4 operator+(const Vec4& other) const { return FromSimd(_mm_add_ps(Load(), other.Load())); }
+    Vec4 operator-(const Vec4& other) const { return FromSimd(_mm_sub_ps(Load(), other.Load())); }
+    Vec4 operator*(const Vec4& other) const { return FromSimd(_mm_mul_ps(Load(), other.Load())); }
+    Vec4 operator*(float s) const { return FromSimd(_mm_mul_ps(Load(), _mm_set1_ps(s))); }
+#else
+    Vec4 operator+(const Vec4& o) const { return Vec4(x + o.x, y + o.y, z + o.z, w + o.w); }
+    Vec4 operator-(const Vec4& o) const { return Vec4(x - o.x, y - o.y, z - o.z, w - o.w); }
+    Vec4 operator*(const Vec4& o) const { return Vec4(x * o.x, y * o.y, z * o.z, w * o.w); }
+    Vec4 operator*(float s) const { return Vec4(x * s, y * s, z * s, w * s); }
+#endif
+
+    float Dot(const Vec4& o) const { return x * o.x + y * o.y + z * o.z + w * o.w; }
+};
\ No newline at end of file
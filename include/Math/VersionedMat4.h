@@ -0,0 +1,28 @@
+﻿#pragma once
+#include <cstring>
+#include "Math/Mat4.h"
+
+// 带版本号的矩阵：内容变化时版本号加1
+// 缓存变换结果的一方记下版本号，版本号没变就可以直接复用上次的结果
+class VersionedMat4
+{
+public:
+    VersionedMat4() : m_Version(0) {}
+    explicit VersionedMat4(const Mat4& matrix) : m_Matrix(matrix), m_Version(0) {}
+
+    const Mat4& Get() const { return m_Matrix; }
+    unsigned int GetVersion() const { return m_Version; }
+
+    // 与当前值逐位相同时不算修改，每帧重复设置同一个矩阵不会让缓存失效
+    void Set(const Mat4& matrix)
+    {
+        if (std::memcmp(m_Matrix.m, matrix.m, sizeof(m_Matrix.m)) == 0)
+            return;
+        m_Matrix = matrix;
+        ++m_Version;
+    }
+
+private:
+    Mat4 m_Matrix;
+    unsigned int m_Version;
+};
\ No newline at end of file